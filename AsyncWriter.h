@@ -0,0 +1,133 @@
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Writes CSV rows from a background thread.
+///
+/// The simulation thread only copies each row's values into a bounded
+/// single-producer, single-consumer ring buffer; a writer thread formats
+/// whole batches of rows and writes and flushes them, so disk stalls never
+/// reach the simulation. When the buffer is full, Push() waits for the
+/// writer to catch up instead of growing it.
+class AsyncCsvWriter {
+public:
+  /// One column of the file.
+  struct Column {
+    std::string name;
+    bool is_int;  ///< Printed as an integer rather than a double.
+  };
+
+private:
+  std::ofstream out;
+  std::vector<Column> columns;
+  size_t capacity;              ///< Rows the ring buffer holds.
+  std::vector<double> slots;    ///< capacity rows of columns.size() values.
+  std::atomic<size_t> head{0};  ///< Rows pushed; written only by the producer.
+  std::atomic<size_t> tail{0};  ///< Rows in the file; written only by the writer.
+  std::atomic<bool> stopping{false};
+
+  std::mutex wake_mutex;  ///< Only guards sleeping; rows never go through a lock.
+  std::condition_variable wake;
+  std::thread writer;
+
+  void WriterLoop() {
+    std::string text;
+    while (true) {
+      size_t t = tail.load(std::memory_order_relaxed);
+      size_t h = head.load(std::memory_order_acquire);
+      if (t == h) {
+        if (stopping.load(std::memory_order_acquire) && h == head.load(std::memory_order_acquire)) break;
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        // Timed, so a wakeup sent just before sleeping is never lost for long
+        wake.wait_for(lock, std::chrono::milliseconds(10));
+        continue;
+      }
+
+      text.clear();
+      for (; t != h; t++) {
+        const double *row = &slots[(t % capacity) * columns.size()];
+        for (size_t c = 0; c < columns.size(); c++) {
+          if (c) text += ',';
+          if (columns[c].is_int) text += std::to_string(static_cast<int64_t>(row[c]));
+          else text += FormatDouble(row[c]);
+        }
+        text += '\n';
+      }
+      out.write(text.data(), text.size());
+      out.flush();
+      tail.store(t, std::memory_order_release);
+    }
+  }
+
+  /// @return value as an ostream prints it by default, like emp::DataFile.
+  static std::string FormatDouble(double value) {
+    thread_local std::ostringstream stream;
+    stream.str("");
+    stream << value;
+    return stream.str();
+  }
+
+public:
+  /// @param filename The file to create.
+  /// @param columns The columns, in file order; the header row is their names.
+  /// @param append Add rows to the end of an existing file, without a header.
+  /// @param capacity Rows buffered before Push() waits for the writer.
+  AsyncCsvWriter(const std::string &filename, std::vector<Column> columns, bool append = false,
+                 size_t capacity = 4096)
+      : out(filename, append ? std::ios::app : std::ios::out), columns(std::move(columns)),
+        capacity(capacity), slots(capacity * this->columns.size()) {
+    if (!append) {
+      for (size_t c = 0; c < this->columns.size(); c++) {
+        out << (c ? "," : "") << this->columns[c].name;
+      }
+      out << '\n' << std::flush;
+    }
+    writer = std::thread([this] { WriterLoop(); });
+  }
+
+  /// Writes every buffered row, then stops the writer thread.
+  ~AsyncCsvWriter() {
+    stopping.store(true, std::memory_order_release);
+    wake.notify_one();
+    writer.join();
+  }
+
+  AsyncCsvWriter(const AsyncCsvWriter &) = delete;
+  AsyncCsvWriter &operator=(const AsyncCsvWriter &) = delete;
+
+  /// Queue one row. Only ever call from one thread.
+  /// @param values One value per column.
+  void Push(const std::vector<double> &values) {
+    const size_t h = head.load(std::memory_order_relaxed);
+    while (h - tail.load(std::memory_order_acquire) == capacity) {
+      wake.notify_one();
+      std::this_thread::yield();
+    }
+    double *row = &slots[(h % capacity) * columns.size()];
+    for (size_t c = 0; c < columns.size(); c++) row[c] = c < values.size() ? values[c] : 0.0;
+    head.store(h + 1, std::memory_order_release);
+    wake.notify_one();
+  }
+
+  /// Wait until every row pushed so far is in the file.
+  void Flush() {
+    const size_t h = head.load(std::memory_order_relaxed);
+    while (tail.load(std::memory_order_acquire) != h) {
+      wake.notify_one();
+      std::this_thread::yield();
+    }
+  }
+};
+
+#endif // ASYNCWRITER_H
@@ -0,0 +1,46 @@
+#ifndef BIRTHQUEUE_H
+#define BIRTHQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// The cells that asked to reproduce this update, each listed once, in the
+/// order of their first request. A bitset over grid positions makes
+/// rejecting a repeat request O(1); Clear() only visits the queued cells, so
+/// no part of the queue costs time proportional to the grid.
+class BirthQueue {
+  std::vector<uint64_t> queued;  ///< One bit per cell.
+  std::vector<uint32_t> cells;   ///< Queued cells, in request order.
+
+public:
+  /// Queue a cell unless it is already queued.
+  /// @return Whether the cell was added.
+  bool Push(size_t cell) {
+    const size_t word = cell / 64;
+    const uint64_t bit = uint64_t(1) << (cell % 64);
+    if (word >= queued.size()) queued.resize(word + 1, 0);
+    if (queued[word] & bit) return false;
+    queued[word] |= bit;
+    cells.push_back(cell);
+    return true;
+  }
+
+  bool Contains(size_t cell) const {
+    return cell / 64 < queued.size() && (queued[cell / 64] >> (cell % 64) & 1);
+  }
+
+  size_t size() const { return cells.size(); }
+  bool empty() const { return cells.empty(); }
+  size_t Bytes() const { return queued.capacity() * sizeof(uint64_t) + cells.capacity() * sizeof(uint32_t); }
+  auto begin() const { return cells.begin(); }
+  auto end() const { return cells.end(); }
+
+  /// Empty the queue, keeping its storage.
+  void Clear() {
+    for (uint32_t cell : cells) queued[cell / 64] &= ~(uint64_t(1) << (cell % 64));
+    cells.clear();
+  }
+};
+
+#endif // BIRTHQUEUE_H
@@ -3,15 +3,46 @@
 #include "sgpl/hardware/Cpu.hpp"
 #include "sgpl/program/Program.hpp"
 #include "sgpl/spec/Spec.hpp"
-#include "ConfigSetup.h"
+#include "Checkpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 /**
  * Represents the virtual CPU and the program genome for an organism in the SGP
- * mode.
+ * mode. GenomeLength is the number of instructions in every genome; mutations
+ * only ever replace instructions, so it is fixed for the whole run, and
+ * genomes of any other length are rejected. It only fixes the length: the
+ * genome is still an sgpl::Program on the heap, because SignalGP-Lite runs
+ * and anchors programs only in that form.
  */
-class CPU {
+template <size_t GenomeLength>
+class BasicCPU {
+  static_assert(GenomeLength > 0, "Genomes need at least one instruction");
+
   sgpl::Cpu<Spec> cpu;
-  sgpl::Program<Spec> program;
+  // Genomes are shared copy-on-write: offspring point at their parent's
+  // program until a mutation actually changes it.
+  std::shared_ptr<const sgpl::Program<Spec>> program;
+
+  /**
+   * Input: The per-instruction mutation rate, above 0.
+   *
+   * Output: How many instructions to skip before the next mutated one.
+   *
+   * Purpose: Draws the gap between mutation sites from the geometric
+   * distribution, so finding the sites costs one draw per mutation rather
+   * than one per instruction. Gaps past the genome are capped at its length.
+   */
+  static size_t SitesToSkip(double mutation_rate) {
+    if (mutation_rate >= 1.0) return 0;
+    const double gap = std::log(1.0 - sgpl::tlrand.Get().GetDouble()) / std::log1p(-mutation_rate);
+    return static_cast<size_t>(std::min(gap, static_cast<double>(GenomeLength)));
+  }
 
   /**
    * Input: None
@@ -22,30 +53,49 @@ class CPU {
    * Should be called when a new CPU is created or the program is changed.
    */
   void InitializeState() {
-    cpu.InitializeAnchors(program);
-    // Fill the input buffer with random values so they can't cheat and exploit
-    // the zeroes that would otherwise be here (e.g. 0^2 is just 0)
+    cpu.InitializeAnchors(*program);
+    FillInputs();
+  }
+
+  /**
+   * Input: None
+   *
+   * Output: None
+   *
+   * Purpose: Rewinds the input stream and fills the input buffer with its
+   * first four values (one Philox block), so they can't cheat and exploit
+   * the zeroes that would otherwise be here (e.g. 0^2 is just 0).
+   */
+  void FillInputs() {
+    state.input_stream.Seek(0);
     for (int i = 0; i < 4; i++) {
-      state.last_inputs[i] = sgpl::tlrand.Get().GetDouble();
+      state.Inputs()[i] = state.input_stream.Next();
     }
   }
 
 public:
+  static constexpr size_t genome_length = GenomeLength;
+
   OrgState state;
 
 
   /**
    * Constructs a new CPU for an ancestor organism with a random genome.
    */
-  CPU(emp::Ptr<OrgWorld> world) : program(100), state{world} {
+  BasicCPU() : program(std::make_shared<sgpl::Program<Spec>>(GenomeLength)) {
     InitializeState();
   }
 
   /**
-   * Constructs a new CPU with a copy of an existing genome.
+   * Constructs a new CPU with a copy of an existing genome, which must be
+   * GenomeLength instructions long.
    */
-  CPU(emp::Ptr<OrgWorld> world, const sgpl::Program<Spec> &program)
-      : program(program), state{world} {
+  explicit BasicCPU(const sgpl::Program<Spec> &program)
+      : program(std::make_shared<sgpl::Program<Spec>>(program)) {
+    if (program.size() != GenomeLength) {
+      throw std::invalid_argument("Genome has " + std::to_string(program.size()) +
+                                  " instructions, expected " + std::to_string(GenomeLength));
+    }
     InitializeState();
   }
 
@@ -54,12 +104,27 @@ public:
    *
    * Output: None
    *
-   * Purpose: Resets the CPU to its initial state.
+   * Purpose: Resets the CPU to its initial state. The input buffer is
+   * filled by StartInputStream(), once the organism has its new stream.
    */
   void Reset() {
     cpu.Reset();
-    state = OrgState{state.world};
-    InitializeState();
+    state = OrgState{};
+    state.input_stream = InputStream{};  // A reset organism is a new individual
+    cpu.InitializeAnchors(*program);
+  }
+
+  /**
+   * Input: The world's input seed and a new organism ID.
+   *
+   * Output: None
+   *
+   * Purpose: Gives the organism its own input stream and refills the input
+   * buffer from it.
+   */
+  void StartInputStream(uint64_t seed, uint64_t id) {
+    state.input_stream.Start(seed, id);
+    FillInputs();
   }
 
   /**
@@ -74,23 +139,45 @@ public:
       cpu.TryLaunchCore();
     }
 
-    sgpl::execute_cpu_n_cycles<Spec>(n_cycles, cpu, program, state);
+    sgpl::execute_cpu_n_cycles<Spec>(n_cycles, cpu, *program, state);
   }
 
   /**
-   * Input: None
+   * Input: The per-instruction mutation rate.
    *
    * Output: None
    *
-   * Purpose: Mutates the genome code stored in the CPU.
+   * Purpose: Mutates the genome code stored in the CPU. Each instruction is
+   * replaced by a random one with probability mutation_rate. The mutation
+   * sites are drawn first, so a genome with no mutations is left shared and
+   * costs nothing; otherwise it is cloned once, the sites are replaced in the
+   * clone, and the jump table is rebuilt.
    */
-  void Mutate() {
-    //TODO: apply mutations!
-    MyConfigType config;
-    InitializeState();
-    program.ApplyPointMutations(config.MUTATION_RATE());
+  void Mutate(double mutation_rate) {
+    if (!(mutation_rate > 0.0)) return;
+    size_t pos = SitesToSkip(mutation_rate);
+    if (pos >= GenomeLength) return;
+
+    auto genome = std::make_shared<sgpl::Program<Spec>>(*program);
+    PROFILE_COUNT(profiler::ALLOCATIONS, 1);
+    for (; pos < GenomeLength; pos += 1 + SitesToSkip(mutation_rate)) {
+      (*genome)[pos] = sgpl::Program<Spec>(1)[0];  // A random instruction
+    }
+    program = std::move(genome);
+    // Keep the jump table in step with the genome that will actually run
+    cpu.InitializeAnchors(*program);
   }
 
+  /**
+   * Input: The CPU whose genome should be copied.
+   *
+   * Output: None
+   *
+   * Purpose: Makes this CPU share another's genome; nothing is copied.
+   * Call Reset() afterwards to rebuild the CPU around it.
+   */
+  void CopyGenome(const BasicCPU &other) { program = other.program; }
+
   /**
    * Input: None
    *
@@ -98,7 +185,103 @@ public:
    *
    * Purpose: Get the genome (program) of an Organism from its CPU
    */
-  const sgpl::Program<Spec> &GetProgram() const { return program; }
+  const sgpl::Program<Spec> &GetProgram() const { return *program; }
+
+  /**
+   * Input: None
+   *
+   * Output: Returns the shared handle to the CPU's program
+   *
+   * Purpose: Lets checkpoints store each shared genome once.
+   */
+  const std::shared_ptr<const sgpl::Program<Spec>> &GetProgramHandle() const {
+    return program;
+  }
+
+  /**
+   * Input: A program and the checkpoint being written.
+   *
+   * Output: None
+   *
+   * Purpose: Appends every instruction's operation, arguments and tag bits.
+   */
+  static void SaveProgram(const sgpl::Program<Spec> &genome, checkpoint::Writer &out) {
+    out.Put<uint64_t>(genome.size());
+    for (const sgpl::Instruction<Spec> &ins : genome) {
+      out.Put(ins.op_code);
+      out.Put(ins.args);
+      for (size_t i = 0; i < ins.tag.GetSize(); i += 8) {
+        uint8_t byte = 0;
+        for (size_t b = 0; b < 8 && i + b < ins.tag.GetSize(); b++) {
+          byte |= uint8_t(ins.tag.Get(i + b)) << b;
+        }
+        out.Put(byte);
+      }
+    }
+  }
+
+  /**
+   * Input: The checkpoint being read.
+   *
+   * Output: Returns the program written by SaveProgram.
+   *
+   * Purpose: Rebuilds a genome from a checkpoint. Throws if the genome was
+   * saved by a build with a different genome length.
+   */
+  static std::shared_ptr<const sgpl::Program<Spec>> LoadProgram(checkpoint::Reader &in) {
+    const uint64_t length = in.Get<uint64_t>();
+    if (length != GenomeLength) {
+      throw std::runtime_error("Checkpoint genome has " + std::to_string(length) +
+                               " instructions, this build expects " + std::to_string(GenomeLength));
+    }
+    auto genome = std::make_shared<sgpl::Program<Spec>>();
+    genome->resize(GenomeLength);
+    for (sgpl::Instruction<Spec> &ins : *genome) {
+      in.Get(ins.op_code);
+      in.Get(ins.args);
+      for (size_t i = 0; i < ins.tag.GetSize(); i += 8) {
+        uint8_t byte = in.Get<uint8_t>();
+        for (size_t b = 0; b < 8 && i + b < ins.tag.GetSize(); b++) {
+          ins.tag.Set(i + b, (byte >> b) & 1);
+        }
+      }
+    }
+    return genome;
+  }
+
+  /**
+   * Input: The checkpoint being written.
+   *
+   * Output: None
+   *
+   * Purpose: Appends the running core's program counter and registers.
+   */
+  void SaveCore(checkpoint::Writer &out) {
+    out.Put<uint8_t>(cpu.HasActiveCore());
+    if (!cpu.HasActiveCore()) return;
+    auto &core = cpu.GetActiveCore();
+    out.Put<uint64_t>(core.GetProgramCounter());
+    out.Put(core.registers);
+  }
+
+  /**
+   * Input: The organism's genome and the checkpoint being read.
+   *
+   * Output: None
+   *
+   * Purpose: Rebuilds the CPU around the genome and restores the core state
+   * written by SaveCore. The organism's state is restored separately.
+   */
+  void LoadCore(std::shared_ptr<const sgpl::Program<Spec>> genome, checkpoint::Reader &in) {
+    program = std::move(genome);
+    cpu.Reset();
+    cpu.InitializeAnchors(*program);
+    if (!in.Get<uint8_t>()) return;
+    cpu.TryLaunchCore();
+    auto &core = cpu.GetActiveCore();
+    core.JumpToIdx(in.Get<uint64_t>());
+    in.Get(core.registers);
+  }
 
 private:
   /**
@@ -174,8 +357,11 @@ public:
                                           {"Subtract", 3}, {"Divide", 3},
                                           {"IO", 1},       {"Reproduce", 0}};
 
-    for (auto i : program) {
+    for (auto i : *program) {
       PrintOp(i, arities, cpu.GetActiveCore().GetGlobalJumpTable(), out);
     }
   }
-};
\ No newline at end of file
+};
+
+/// The CPU every organism in this model runs, with 100-instruction genomes.
+using CPU = BasicCPU<100>;
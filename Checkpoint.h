@@ -0,0 +1,100 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/// Binary world checkpoints.
+///
+/// A checkpoint is a flat little-endian dump of plain values, built in
+/// memory and written with a single call. Writer and Reader only move bytes;
+/// OrgWorld::SaveCheckpoint and OrgWorld::LoadCheckpoint define the layout.
+namespace checkpoint {
+
+constexpr char MAGIC[4] = {'O', 'V', 'C', 'K'};
+constexpr uint8_t VERSION = 3;
+
+/// Collects a checkpoint in memory.
+class Writer {
+  std::string data;
+
+public:
+  Writer() {
+    data.append(MAGIC, sizeof(MAGIC));
+    data.push_back(static_cast<char>(VERSION));
+  }
+
+  /// Append the raw bytes of a trivially copyable value.
+  template <typename T>
+  void Put(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be checkpointed");
+    data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  /// Write the checkpoint to a temporary file, then move it over filename,
+  /// so an interrupted save never destroys the previous checkpoint.
+  void Save(const std::string &filename) const {
+    const std::string temp = filename + ".tmp";
+    {
+      std::ofstream out(temp, std::ios::binary);
+      out.write(data.data(), data.size());
+      if (!out) throw std::runtime_error("Cannot write " + temp);
+    }
+    if (std::rename(temp.c_str(), filename.c_str()) != 0) {
+      throw std::runtime_error("Cannot replace " + filename);
+    }
+  }
+};
+
+/// Reads back the values of a checkpoint in the order they were written.
+class Reader {
+  std::string data;
+  const char *pos = nullptr;
+  const char *end = nullptr;
+
+public:
+  explicit Reader(const std::string &filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open " + filename);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    pos = data.data();
+    end = pos + data.size();
+
+    if (data.size() < sizeof(MAGIC) + 1 || std::memcmp(pos, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error(filename + " is not a checkpoint file");
+    }
+    pos += sizeof(MAGIC);
+    if (static_cast<uint8_t>(*pos++) != VERSION) {
+      throw std::runtime_error(filename + " has an unsupported version");
+    }
+  }
+
+  /// Overwrite value with the next sizeof(T) bytes.
+  template <typename T>
+  void Get(T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be checkpointed");
+    if (static_cast<size_t>(end - pos) < sizeof(T)) {
+      throw std::runtime_error("Truncated checkpoint");
+    }
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+  }
+
+  /// @return The next value, read as a T.
+  template <typename T>
+  T Get() {
+    T value;
+    Get(value);
+    return value;
+  }
+};
+
+} // namespace checkpoint
+
+#endif // CHECKPOINT_H
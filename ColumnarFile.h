@@ -0,0 +1,303 @@
+#ifndef COLUMNARFILE_H
+#define COLUMNARFILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Binary, column-oriented data files.
+///
+/// Layout (all integers are LEB128 varints unless noted):
+///   "OVCF" magic, 1 byte version
+///   column count, then per column: 1 byte type, name length, name,
+///   description length, description
+///   blocks until end of file: row count, then per column the encoded
+///   byte length followed by that column's values for every row
+///
+/// Int columns store the zigzag-encoded difference from the previous row.
+/// Double columns store the bitwise XOR with the previous row, shifted right
+/// past its trailing zero bits, so repeated and whole-number values stay
+/// short. Both restart from zero at each block. Each column's bytes are then
+/// zero-run packed: a 0 byte is followed by the length of the run it starts,
+/// so a column that never changes costs a few bytes per block.
+namespace columnar {
+
+constexpr char MAGIC[4] = {'O', 'V', 'C', 'F'};
+constexpr uint8_t VERSION = 1;
+constexpr size_t BLOCK_ROWS = 4096;  ///< Most rows a block holds.
+constexpr size_t MAX_VALUE_BYTES = 11;  ///< A shift byte and a 64-bit varint.
+
+enum class ColumnType : uint8_t { Int = 0, Double = 1 };
+
+inline void PutVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline uint64_t GetVarint(const char *&in, const char *end) {
+  uint64_t value = 0;
+  for (int shift = 0; in < end && shift < 64; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*in++);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+  throw std::runtime_error("Truncated varint in columnar file");
+}
+
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline uint64_t DoubleBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// Replace every run of zero bytes with a 0 byte and the run length.
+inline std::string PackZeros(const std::string &in) {
+  std::string out;
+  for (size_t i = 0; i < in.size();) {
+    if (in[i] != 0) {
+      out.push_back(in[i++]);
+      continue;
+    }
+    size_t run = 0;
+    while (i < in.size() && in[i] == 0) {
+      run++;
+      i++;
+    }
+    out.push_back(0);
+    PutVarint(out, run);
+  }
+  return out;
+}
+
+/// Reverse PackZeros().
+/// @param limit Most bytes the unpacked data may take up.
+inline std::string UnpackZeros(const char *in, const char *end, size_t limit) {
+  std::string out;
+  while (in < end) {
+    char byte = *in++;
+    if (byte != 0) {
+      out.push_back(byte);
+    } else {
+      uint64_t run = GetVarint(in, end);
+      if (run > limit - out.size()) throw std::runtime_error("Zero run past the end of a column");
+      out.append(run, '\0');
+    }
+    if (out.size() > limit) throw std::runtime_error("Column longer than its block");
+  }
+  return out;
+}
+
+/// Description of one column in a file.
+struct ColumnInfo {
+  ColumnType type;
+  std::string name;
+  std::string desc;
+};
+
+/// Writes rows to a columnar file, buffering each column and flushing a
+/// block every BLOCK_ROWS rows and on destruction.
+class Writer {
+  struct Column {
+    ColumnInfo info;
+    std::function<double()> get;  ///< Reads the column's current value.
+    uint64_t last = 0;            ///< Previous value (int or bits) in this block.
+    std::string bytes;            ///< Encoded values of this block.
+  };
+
+  std::ofstream out;
+  std::vector<Column> columns;
+  size_t block_rows = 0;
+  bool header_written = false;
+
+  void WriteHeader() {
+    std::string header(MAGIC, sizeof(MAGIC));
+    header.push_back(static_cast<char>(VERSION));
+    PutVarint(header, columns.size());
+    for (const Column &column : columns) {
+      header.push_back(static_cast<char>(column.info.type));
+      PutVarint(header, column.info.name.size());
+      header += column.info.name;
+      PutVarint(header, column.info.desc.size());
+      header += column.info.desc;
+    }
+    out.write(header.data(), header.size());
+    header_written = true;
+  }
+
+public:
+  /// @param filename The file to write.
+  /// @param append Add blocks to the end of an existing file instead of starting a new one.
+  explicit Writer(const std::string &filename, bool append = false)
+      : out(filename, append ? std::ios::binary | std::ios::app : std::ios::binary),
+        header_written(append) {}
+
+  ~Writer() { Flush(); }
+
+  Writer(const Writer &) = delete;
+  Writer &operator=(const Writer &) = delete;
+
+  /// Add a column; all columns must be added before the first row.
+  /// @param name Column key, as in the CSV header.
+  /// @param desc Human-readable description.
+  /// @param type How values are encoded.
+  /// @param get Returns the value to record for the current row.
+  void AddColumn(const std::string &name, const std::string &desc,
+                 ColumnType type, std::function<double()> get) {
+    columns.push_back({{type, name, desc}, std::move(get)});
+  }
+
+  /// Append one row made of every column's current value.
+  void WriteRow() {
+    if (!header_written) WriteHeader();
+    for (Column &column : columns) {
+      double value = column.get();
+      if (column.info.type == ColumnType::Int) {
+        uint64_t current = static_cast<uint64_t>(static_cast<int64_t>(value));
+        PutVarint(column.bytes, ZigZag(static_cast<int64_t>(current - column.last)));
+        column.last = current;
+      } else {
+        uint64_t bits = DoubleBits(value);
+        uint64_t diff = bits ^ column.last;
+        uint8_t shift = diff ? __builtin_ctzll(diff) : 0;
+        column.bytes.push_back(static_cast<char>(shift));
+        PutVarint(column.bytes, diff >> shift);
+        column.last = bits;
+      }
+    }
+    if (++block_rows == BLOCK_ROWS) Flush();
+  }
+
+  /// Write out any buffered rows as a block.
+  void Flush() {
+    if (!header_written) WriteHeader();
+    if (block_rows == 0) {
+      out.flush();
+      return;
+    }
+    std::string block;
+    PutVarint(block, block_rows);
+    for (Column &column : columns) {
+      std::string packed = PackZeros(column.bytes);
+      PutVarint(block, packed.size());
+      block += packed;
+      column.bytes.clear();
+      column.last = 0;
+    }
+    out.write(block.data(), block.size());
+    out.flush();
+    block_rows = 0;
+  }
+};
+
+/// Reads a columnar file one block at a time. Lengths and counts read from
+/// the file are checked against the bytes left, so a truncated or corrupt
+/// file throws std::runtime_error instead of being read past its end.
+class Reader {
+  std::string data;
+  const char *pos = nullptr;
+  const char *end = nullptr;
+  std::vector<ColumnInfo> columns;
+
+  /// @return The next size bytes, after checking there are that many left.
+  const char *Take(uint64_t size) {
+    if (size > static_cast<uint64_t>(end - pos)) throw std::runtime_error("Truncated columnar file");
+    const char *start = pos;
+    pos += size;
+    return start;
+  }
+
+public:
+  explicit Reader(const std::string &filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open " + filename);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    pos = data.data();
+    end = pos + data.size();
+
+    if (data.size() < sizeof(MAGIC) + 1 || std::memcmp(pos, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error(filename + " is not a columnar data file");
+    }
+    pos += sizeof(MAGIC);
+    if (static_cast<uint8_t>(*pos++) != VERSION) {
+      throw std::runtime_error(filename + " has an unsupported version");
+    }
+
+    uint64_t num_columns = GetVarint(pos, end);
+    for (uint64_t i = 0; i < num_columns; i++) {
+      ColumnInfo info;
+      uint8_t type = static_cast<uint8_t>(*Take(1));
+      if (type > static_cast<uint8_t>(ColumnType::Double)) {
+        throw std::runtime_error(filename + " has an unknown column type");
+      }
+      info.type = static_cast<ColumnType>(type);
+      uint64_t name_size = GetVarint(pos, end);
+      info.name.assign(Take(name_size), name_size);
+      uint64_t desc_size = GetVarint(pos, end);
+      info.desc.assign(Take(desc_size), desc_size);
+      columns.push_back(std::move(info));
+    }
+  }
+
+  /// @return The columns in file order.
+  const std::vector<ColumnInfo> &GetColumns() const { return columns; }
+
+  /// Decode the next block.
+  /// @param values Filled with one vector of row values per column.
+  /// @return False once the end of the file is reached.
+  bool ReadBlock(std::vector<std::vector<double>> &values) {
+    if (pos >= end) return false;
+    uint64_t rows = GetVarint(pos, end);
+    if (rows > BLOCK_ROWS) throw std::runtime_error("Columnar block has too many rows");
+    values.resize(columns.size());
+    for (size_t c = 0; c < columns.size(); c++) {
+      uint64_t size = GetVarint(pos, end);
+      const char *packed = Take(size);
+      std::string bytes = UnpackZeros(packed, packed + size, rows * MAX_VALUE_BYTES);
+      const char *col = bytes.data();
+      const char *col_end = col + bytes.size();
+
+      std::vector<double> &out = values[c];
+      out.resize(rows);
+      uint64_t last = 0;
+      for (size_t r = 0; r < rows; r++) {
+        if (columns[c].type == ColumnType::Int) {
+          last += static_cast<uint64_t>(UnZigZag(GetVarint(col, col_end)));
+          out[r] = static_cast<double>(static_cast<int64_t>(last));
+        } else {
+          if (col == col_end) throw std::runtime_error("Truncated column in columnar file");
+          uint8_t shift = static_cast<uint8_t>(*col++);
+          if (shift >= 64) throw std::runtime_error("Bad shift in columnar file");
+          last ^= GetVarint(col, col_end) << shift;
+          out[r] = BitsDouble(last);
+        }
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace columnar
+
+#endif // COLUMNARFILE_H
@@ -7,9 +7,30 @@ EMP_BUILD_CONFIG( MyConfigType,
   VALUE(SEED, int, 1, "Random number seed"),
   VALUE(NUM_START, int, 10, "Number of organisms to start with"),
   VALUE(MUTATION_RATE, double, 0.01, "Mutation rate per instruction"),
+  VALUE(GRID_WIDTH, int, 10, "Width of the world grid"),
+  VALUE(GRID_HEIGHT, int, 10, "Height of the world grid"),
+  VALUE(NUM_UPDATES, int, 1000, "Updates to run each world for"),
+  VALUE(CYCLES_PER_UPDATE, int, 10, "CPU cycles each organism runs per update"),
+  VALUE(SCHEDULER, std::string, "uniform", "CPU time per organism: uniform, or merit (proportional to MERIT_BASE + last task reward)"),
+  VALUE(MERIT_BASE, double, 1.0, "Merit of an organism with no completed task under the merit scheduler"),
+  VALUE(MOVEMENT, bool, false, "Each update, organisms try to move to a random empty neighboring cell"),
   VALUE(NUM_TASKS, int, 7, "How many tasks should be in the world?"),
   VALUE(FILE_PATH, std::string, "", "Output file path"),
-  VALUE(FILE_NAME, std::string, "_data.dat", "Root output file name")
+  VALUE(FILE_NAME, std::string, "_data.dat", "Root output file name"),
+  VALUE(OUTPUT_SCHEDULE, std::string, "every", "Updates to gather statistics and write rows on: every, log or final"),
+  VALUE(OUTPUT_INTERVAL, int, 1, "every: updates between rows; log: rows per decade of updates"),
+  VALUE(OUTPUT_FORMAT, std::string, "csv", "Data file format: csv, async (csv written by a background thread) or binary (read with export_data)"),
+  VALUE(NUM_THREADS, int, 0, "Threads that process organisms each update (0 = classic serial update; ignored in batches)"),
+  VALUE(NUM_REPS, int, 1, "Replicates to run in one process, with seeds SEED, SEED+1, ..."),
+  VALUE(MUTATION_RATES, std::string, "", "Comma-separated mutation rates to sweep (empty = MUTATION_RATE)"),
+  VALUE(BATCH_THREADS, int, 0, "Threads that run replicates concurrently (0 = all cores)"),
+  VALUE(SUMMARY_FILE, std::string, "", "Batch runs: write per-update mean, SD and 95% CI across replicates here (empty = off)"),
+  VALUE(WRITE_REP_FILES, bool, true, "Batch runs: also write one data file per replicate"),
+  VALUE(CHECKPOINT_INTERVAL, int, 0, "Save each world to Checkpoint<seed>.ckpt every this many updates (0 = never)"),
+  VALUE(RESUME, bool, false, "Continue each world from its checkpoint file if there is one"),
+  VALUE(WARM_START, std::string, "", "Start every world from the population in this checkpoint instead of ancestors"),
+  VALUE(FRAME_BUDGET_MS, double, 12.0, "Web: milliseconds of updates to run per animation frame (0 = one update per frame)"),
+  VALUE(REPORT_MEMORY, bool, false, "Print the bytes each organism takes up at the end of every run")
 );
 
 #endif
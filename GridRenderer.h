@@ -0,0 +1,118 @@
+#ifndef GRIDRENDERER_H
+#define GRIDRENDERER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+/// Draws a grid of colored cells onto a canvas through a pixel buffer.
+///
+/// Cells are painted into the buffer in C++ only when their color changes,
+/// and Present() copies just the bounding box of the changed cells to the
+/// canvas with a single putImageData call, so a frame costs one JS call
+/// however large the grid is. A canvas element the page has (re)created is
+/// blank, so the first Present() to it copies the whole grid. Outside
+/// Emscripten builds Present() only clears the changes, which keeps the
+/// class usable in native code.
+class GridRenderer {
+  std::string canvas_id;
+  size_t cols, rows, cell_size;
+  size_t width, height;          ///< Size of the buffer in pixels.
+  std::vector<uint32_t> pixels;  ///< RGBA bytes, row by row.
+  std::vector<uint32_t> drawn;   ///< Color each cell was last painted; 0 = never.
+
+  // Bounding box of the cells painted since the last Present(), inclusive
+  size_t dirty_min_x = 0, dirty_min_y = 0, dirty_max_x = 0, dirty_max_y = 0;
+  bool dirty = false;
+
+public:
+  /// @return A color with the given channels, laid out as RGBA bytes in memory.
+  static constexpr uint32_t RGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+    return uint32_t(r) | uint32_t(g) << 8 | uint32_t(b) << 16 | uint32_t(a) << 24;
+  }
+
+  static constexpr uint32_t BORDER = 0xFF000000;  ///< Opaque black.
+
+  /// @param canvas_id The id of the canvas element to draw on.
+  /// @param cols Cells across.
+  /// @param rows Cells down.
+  /// @param cell_size Side of a cell in pixels; cells of 3 or more get a border.
+  GridRenderer(const std::string &canvas_id, size_t cols, size_t rows, size_t cell_size)
+      : canvas_id(canvas_id), cols(cols), rows(rows), cell_size(cell_size),
+        width(cols * cell_size), height(rows * cell_size),
+        pixels(width * height, BORDER), drawn(cols * rows, 0) {}
+
+  size_t GetWidth() const { return width; }
+  size_t GetHeight() const { return height; }
+
+  /// Paint a cell, if it is not already that color.
+  /// @param x Column of the cell.
+  /// @param y Row of the cell.
+  /// @param color An opaque color from RGBA().
+  void SetCell(size_t x, size_t y, uint32_t color) {
+    uint32_t &last = drawn[y * cols + x];
+    if (last == color) return;
+    last = color;
+
+    const bool border = cell_size >= 3;
+    uint32_t *row = pixels.data() + y * cell_size * width + x * cell_size;
+    for (size_t py = 0; py < cell_size; py++, row += width) {
+      for (size_t px = 0; px < cell_size; px++) {
+        row[px] = border && (px == 0 || py == 0) ? BORDER : color;
+      }
+    }
+
+    if (!dirty) {
+      dirty_min_x = dirty_max_x = x;
+      dirty_min_y = dirty_max_y = y;
+      dirty = true;
+    } else {
+      dirty_min_x = std::min(dirty_min_x, x);
+      dirty_max_x = std::max(dirty_max_x, x);
+      dirty_min_y = std::min(dirty_min_y, y);
+      dirty_max_y = std::max(dirty_max_y, y);
+    }
+  }
+
+  /// Copy the whole grid on the next Present(), e.g. after the canvas was cleared.
+  void Invalidate() {
+    dirty_min_x = dirty_min_y = 0;
+    dirty_max_x = cols - 1;
+    dirty_max_y = rows - 1;
+    dirty = true;
+  }
+
+  /// Copy the cells painted since the last call to the canvas.
+  void Present() {
+#ifdef __EMSCRIPTEN__
+    size_t x = 0, y = 0, w = 0, h = 0;
+    if (dirty) {
+      x = dirty_min_x * cell_size;
+      y = dirty_min_y * cell_size;
+      w = (dirty_max_x + 1) * cell_size - x;
+      h = (dirty_max_y + 1) * cell_size - y;
+    }
+    EM_ASM({
+      var canvas = document.getElementById(UTF8ToString($0));
+      if (!canvas) return;
+      var x = $4, y = $5, w = $6, h = $7;
+      if (!canvas.gridRendererDrawn) {
+        canvas.gridRendererDrawn = true;
+        x = 0; y = 0; w = $2; h = $3;
+      }
+      if (w == 0) return;
+      var image = new ImageData(new Uint8ClampedArray(HEAPU8.buffer, $1, $2 * $3 * 4), $2, $3);
+      canvas.getContext('2d').putImageData(image, 0, 0, x, y, w, h);
+    }, canvas_id.c_str(), pixels.data(), width, height, x, y, w, h);
+#endif
+    dirty = false;
+  }
+};
+
+#endif // GRIDRENDERER_H
@@ -0,0 +1,81 @@
+#ifndef HOTSTATE_H
+#define HOTSTATE_H
+
+#include "emp/base/vector.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// A dense list of the occupied cells, kept up to date as organisms are
+/// placed and removed, so sweeps cost time per organism rather than per cell.
+/// Removing a cell moves the last entry into its slot, so both insertion and
+/// removal are O(1) and the order only depends on the sequence of changes.
+class OccupiedIndex {
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  emp::vector<uint32_t> cells;  ///< The occupied cells.
+  emp::vector<uint32_t> slots;  ///< Where each cell is in `cells`, or NONE.
+
+public:
+  /// Cover the given number of cells; cells beyond the old size start empty.
+  void Resize(size_t num_cells) { slots.resize(num_cells, NONE); }
+
+  bool Contains(size_t cell) const { return cell < slots.size() && slots[cell] != NONE; }
+
+  void Insert(size_t cell) {
+    if (Contains(cell)) return;
+    slots[cell] = cells.size();
+    cells.push_back(cell);
+  }
+
+  void Erase(size_t cell) {
+    if (!Contains(cell)) return;
+    uint32_t slot = slots[cell];
+    uint32_t last = cells.back();
+    cells[slot] = last;
+    slots[last] = slot;
+    cells.pop_back();
+    slots[cell] = NONE;
+  }
+
+  size_t size() const { return cells.size(); }
+  bool empty() const { return cells.empty(); }
+  size_t Bytes() const { return (cells.capacity() + slots.capacity()) * sizeof(uint32_t); }
+  uint32_t operator[](size_t i) const { return cells[i]; }
+  uint32_t back() const { return cells.back(); }
+  auto begin() const { return cells.begin(); }
+  auto end() const { return cells.end(); }
+};
+
+/// The organism fields that world-level sweeps read every update, stored as
+/// one contiguous array per field and indexed by grid position. A cell's
+/// entries are only meaningful while `occupied` contains it.
+struct HotStateStore {
+  emp::vector<double> points;                        ///< Fitness or score of the organism in each cell.
+  emp::vector<int8_t> last_task_completed;           ///< Last completed task ID; -1 means none.
+  emp::vector<std::array<uint32_t, 4>> last_inputs;  ///< Circular buffer of each organism's 4 most recent inputs.
+  emp::vector<uint8_t> last_input_idx;               ///< Index of the most recent input in each buffer.
+  OccupiedIndex occupied;                            ///< Cells with an organism attached.
+
+  /// Number of cells the store covers.
+  size_t size() const { return points.size(); }
+
+  /// Memory held by the arrays, in bytes.
+  size_t Bytes() const {
+    return points.capacity() * sizeof(double) + last_task_completed.capacity() * sizeof(int8_t) +
+           last_inputs.capacity() * sizeof(last_inputs[0]) + last_input_idx.capacity() +
+           occupied.Bytes();
+  }
+
+  /// Grow or shrink every array to cover the given number of cells.
+  void Resize(size_t num_cells) {
+    points.resize(num_cells, 0.0);
+    last_task_completed.resize(num_cells, -1);
+    last_inputs.resize(num_cells);
+    last_input_idx.resize(num_cells, 0);
+    occupied.Resize(num_cells);
+  }
+};
+
+#endif // HOTSTATE_H
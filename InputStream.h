@@ -0,0 +1,86 @@
+#ifndef INPUTSTREAM_H
+#define INPUTSTREAM_H
+
+#include <array>
+#include <cstdint>
+
+/// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+/// 3"), a counter-based generator: every block of four outputs is a pure
+/// function of a 128-bit counter and a 64-bit key, so any position of any
+/// stream can be computed directly, in any order, on any thread.
+namespace philox {
+
+using Counter = std::array<uint32_t, 4>;
+using Key = std::array<uint32_t, 2>;
+
+/// @return Four random words for the given counter and key.
+inline Counter Block(Counter ctr, Key key) {
+  constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+  for (int round = 0; round < 10; round++) {
+    if (round) {
+      key[0] += W0;
+      key[1] += W1;
+    }
+    const uint64_t p0 = uint64_t(M0) * ctr[0];
+    const uint64_t p1 = uint64_t(M1) * ctr[2];
+    ctr = {uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], uint32_t(p1),
+           uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], uint32_t(p0)};
+  }
+  return ctr;
+}
+
+} // namespace philox
+
+/// The inputs one organism receives, keyed by the world's seed and the
+/// organism's ID. The n-th input is word n % 4 of Philox block n / 4, so a
+/// stream depends only on (seed, ID, IO count): never on which thread runs
+/// the organism or what ran before it, and it can be replayed with At()
+/// without rerunning the world. Each block is generated once and its four
+/// words handed out in turn.
+class InputStream {
+  uint64_t seed = 0;
+  uint64_t id = 0;     ///< 0 until the stream is started.
+  uint64_t count = 0;  ///< Inputs drawn so far.
+  philox::Counter block{};
+
+  static philox::Counter MakeBlock(uint64_t seed, uint64_t id, uint64_t block_index) {
+    return philox::Block({uint32_t(block_index), uint32_t(block_index >> 32), uint32_t(id),
+                          uint32_t(id >> 32)},
+                         {uint32_t(seed), uint32_t(seed >> 32)});
+  }
+
+public:
+  /// Begin the stream of an organism.
+  /// @param new_seed The world's input seed.
+  /// @param new_id The organism's ID (at least 1).
+  void Start(uint64_t new_seed, uint64_t new_id) {
+    seed = new_seed;
+    id = new_id;
+    Seek(0);
+  }
+
+  bool IsStarted() const { return id != 0; }
+  uint64_t GetSeed() const { return seed; }
+  uint64_t GetID() const { return id; }
+  uint64_t GetCount() const { return count; }
+
+  /// Continue from the given number of inputs drawn, e.g. after a checkpoint.
+  void Seek(uint64_t position) {
+    count = position;
+    if (count % 4) block = MakeBlock(seed, id, count / 4);
+  }
+
+  /// @return The next input.
+  uint32_t Next() {
+    if (count % 4 == 0) block = MakeBlock(seed, id, count / 4);
+    return block[count++ % 4];
+  }
+
+  /// @return Input number `position` of the stream of organism `id`.
+  static uint32_t At(uint64_t seed, uint64_t id, uint64_t position) {
+    return MakeBlock(seed, id, position / 4)[position % 4];
+  }
+};
+
+#endif // INPUTSTREAM_H
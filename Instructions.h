@@ -2,6 +2,7 @@
 #define INSTRUCTIONS_H
 
 #include "OrgState.h"
+#include "Profiler.h"
 #include "sgpl/library/OpLibraryCoupler.hpp"
 #include "sgpl/library/prefab/ArithmeticOpLibrary.hpp"
 #include "sgpl/library/prefab/NopOpLibrary.hpp"
@@ -10,6 +11,27 @@
 #include "sgpl/program/Program.hpp"
 #include "sgpl/spec/Spec.hpp"
 //#include <_types/_uint32_t.h>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * SignalGP-Lite registers are floats, which can't hold every 32-bit value
+ * exactly, so task inputs and outputs travel through them as raw bit
+ * patterns rather than being converted to and from numbers.
+ */
+template <typename Register>
+uint32_t GetRegisterBits(const Register &reg) {
+  static_assert(sizeof(Register) == sizeof(uint32_t), "Registers must be 32 bits wide");
+  uint32_t bits;
+  std::memcpy(&bits, &reg, sizeof(bits));
+  return bits;
+}
+
+template <typename Register>
+void SetRegisterBits(Register &reg, uint32_t bits) {
+  static_assert(sizeof(Register) == sizeof(uint32_t), "Registers must be 32 bits wide");
+  std::memcpy(&reg, &bits, sizeof(bits));
+}
 
 /**
  * A custom instruction that outputs the value of a register as the (possible)
@@ -21,11 +43,11 @@ struct IOInstruction {
   static void run(sgpl::Core<Spec> &core, const sgpl::Instruction<Spec> &inst,
                   const sgpl::Program<Spec> &,
                   typename Spec::peripheral_t &state) noexcept {
-    uint32_t output = core.registers[inst.args[0]];
-    state.world->CheckOutput(output, state);
+    uint32_t output = GetRegisterBits(core.registers[inst.args[0]]);
+    state.World().CheckOutput(output, state);
 
-    uint32_t input = sgpl::tlrand.Get().GetUInt();
-    core.registers[inst.args[0]] = input;
+    uint32_t input = state.input_stream.Next();
+    SetRegisterBits(core.registers[inst.args[0]], input);
     state.add_input(input);
   }
 
@@ -38,11 +60,11 @@ struct NandInstruction {
   static void run(sgpl::Core<Spec> &core, const sgpl::Instruction<Spec> &inst,
                   const sgpl::Program<Spec> &,
                   typename Spec::peripheral_t &state) noexcept {
-                    uint32_t reg_b = core.registers[inst.args[1]];
-                    uint32_t reg_c = core.registers[inst.args[2]];
+                    uint32_t reg_b = GetRegisterBits(core.registers[inst.args[1]]);
+                    uint32_t reg_c = GetRegisterBits(core.registers[inst.args[2]]);
                     uint32_t nand_val = ~(reg_b & reg_c);
 
-                    core.registers[inst.args[0]] = nand_val;
+                    SetRegisterBits(core.registers[inst.args[0]], nand_val);
                   }
   static std::string name() { return "Nand"; }
   static size_t prevalence() { return 1; }
@@ -57,9 +79,9 @@ struct ReproduceInstruction {
   static void run(sgpl::Core<Spec> &core, const sgpl::Instruction<Spec> &inst,
                   const sgpl::Program<Spec> &,
                   typename Spec::peripheral_t &state) noexcept {
-    if (state.points > 20) {
-      state.world->ReproduceOrg(state.current_location);
-      state.points = 0;
+    if (state.Points() > 20) {
+      state.World().ReproduceOrg(state.current_location);
+      state.Points() = 0;
     }
     
   }
@@ -70,10 +92,12 @@ struct ReproduceInstruction {
 
 
 
+// In profiling builds every op but the Nop library is counted per execution
 using Library =
-    sgpl::OpLibraryCoupler<sgpl::NopOpLibrary, sgpl::BitwiseShift, sgpl::Increment, sgpl::Decrement,
-    sgpl::Add, sgpl::Subtract, sgpl::global::JumpIfNot, sgpl::local::JumpIfNot, sgpl::global::Anchor, IOInstruction, NandInstruction,
-                           ReproduceInstruction>;
+    sgpl::OpLibraryCoupler<sgpl::NopOpLibrary, PROFILED_OP(sgpl::BitwiseShift), PROFILED_OP(sgpl::Increment),
+    PROFILED_OP(sgpl::Decrement), PROFILED_OP(sgpl::Add), PROFILED_OP(sgpl::Subtract),
+    PROFILED_OP(sgpl::global::JumpIfNot), PROFILED_OP(sgpl::local::JumpIfNot), PROFILED_OP(sgpl::global::Anchor),
+    PROFILED_OP(IOInstruction), PROFILED_OP(NandInstruction), PROFILED_OP(ReproduceInstruction)>;
 
 using Spec = sgpl::Spec<Library, OrgState>;
 
@@ -0,0 +1,65 @@
+#ifndef MERITSAMPLER_H
+#define MERITSAMPLER_H
+
+#include <cstddef>
+#include <vector>
+
+/// Draws slots with probability proportional to their weights, where weights
+/// change one at a time. A Fenwick tree of partial sums makes both changing
+/// a weight and drawing a slot O(log n), so nothing rescans the population
+/// when one organism's merit changes.
+class MeritSampler {
+  std::vector<double> tree;     ///< 1-based Fenwick tree of partial sums.
+  std::vector<double> weights;  ///< Current weight of each slot.
+  size_t top_bit = 0;           ///< Largest power of two no bigger than the slot count.
+  double total = 0.0;
+
+public:
+  /// Replace every weight at once, in O(n).
+  /// @param n Number of slots.
+  /// @param weight_of Returns the weight of a slot (at least 0).
+  template <typename WeightFun>
+  void Build(size_t n, WeightFun weight_of) {
+    weights.resize(n);
+    tree.assign(n + 1, 0.0);
+    total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+      weights[i] = weight_of(i);
+      tree[i + 1] += weights[i];
+      total += weights[i];
+      size_t parent = (i + 1) + ((i + 1) & (~i));
+      if (parent <= n) tree[parent] += tree[i + 1];
+    }
+    top_bit = 1;
+    while (top_bit * 2 <= n) top_bit *= 2;
+  }
+
+  /// Change the weight of one slot.
+  void Set(size_t slot, double weight) {
+    const double delta = weight - weights[slot];
+    if (delta == 0.0) return;
+    weights[slot] = weight;
+    total += delta;
+    for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) tree[i] += delta;
+  }
+
+  double Get(size_t slot) const { return weights[slot]; }
+  double Total() const { return total; }
+  size_t size() const { return weights.size(); }
+
+  /// @param target A value in [0, Total()).
+  /// @return The slot whose share of the running total contains target.
+  size_t Find(double target) const {
+    size_t pos = 0;
+    for (size_t step = top_bit; step > 0; step /= 2) {
+      if (pos + step < tree.size() && tree[pos + step] <= target) {
+        pos += step;
+        target -= tree[pos];
+      }
+    }
+    // Rounding can carry target just past the last slot
+    return pos < weights.size() ? pos : weights.size() - 1;
+  }
+};
+
+#endif // MERITSAMPLER_H
@@ -12,11 +12,10 @@ public:
   int tasks_completed;       ///< Total number of tasks this organism has completed.
 
   /// Constructor to initialize the organism with optional points and task count.
-  /// @param world The world in which the organism exists.
   /// @param points Initial points (fitness) of the organism.
   /// @param tasks_completed Initial count of tasks completed by the organism.
-  Organism(emp::Ptr<OrgWorld> world, double points = 0.0, int tasks_completed = 0)
-    : cpu(world), tasks_completed(tasks_completed) {
+  explicit Organism(double points = 0.0, int tasks_completed = 0)
+    : tasks_completed(tasks_completed) {
     SetPoints(points);
   }
 
@@ -33,43 +32,55 @@ public:
 
   /// Get the ID of the last task this organism completed.
   /// @return The ID of the last task completed.
-  int GetLastTaskCompleted() const { return cpu.state.last_task_completed; }
+  int GetLastTaskCompleted() const { return cpu.state.LastTaskCompleted(); }
 
   /// Set the points (fitness) of this organism.
   /// @param _in The points value to set.
-  void SetPoints(double _in) { cpu.state.points = _in; }
+  void SetPoints(double _in) { cpu.state.Points() = _in; }
 
   /// Add to the points (fitness) of this organism.
   /// @param _in The number of points to add.
-  void AddPoints(double _in) { cpu.state.points += _in; }
+  void AddPoints(double _in) { cpu.state.Points() += _in; }
 
   /// Get the current points (fitness) of this organism.
   /// @return The current points (fitness) of the organism.
-  double GetPoints() { return cpu.state.points; }
+  double GetPoints() { return cpu.state.Points(); }
 
   /// Reset this organism’s internal CPU state, effectively resetting its state.
   void Reset() { cpu.Reset(); }
 
   /// Apply mutations to this organism’s genome, altering its behavior or traits.
-  void Mutate() { cpu.Mutate(); }
+  /// @param mutation_rate The per-instruction mutation rate.
+  void Mutate(double mutation_rate) { cpu.Mutate(mutation_rate); }
 
   /**
    * Check whether the organism should reproduce based on its points.
-   * If the organism has sufficient points (greater than 20), it will reproduce.
-   * A mutated offspring will be returned.
-   * If reproduction conditions are not met, std::nullopt is returned.
+   * If the organism has sufficient points (greater than 20), it pays the
+   * 20 point cost of reproduction.
    * 
-   * @return An optional Organism representing the offspring if reproduction occurs.
+   * @return Whether the organism reproduces.
    */
-  std::optional<Organism> CheckReproduction() {
+  bool CheckReproduction() {
     if (GetPoints() > 20) {
-      Organism offspring = *this;
-      offspring.Reset();
-      offspring.Mutate();
       AddPoints(-20);  // Decrease points after reproduction
-      return offspring;
+      return true;
     }
-    return {};
+    return false;
+  }
+
+  /**
+   * Turn this organism into a fresh, mutated offspring of a parent.
+   * The parent's genome is shared rather than copied, so a recycled
+   * organism becomes an unmutated newborn without any allocation.
+   * 
+   * @param parent The organism reproducing.
+   * @param mutation_rate The per-instruction mutation rate for the offspring.
+   */
+  void BecomeOffspringOf(const Organism &parent, double mutation_rate) {
+    cpu.CopyGenome(parent.cpu);
+    tasks_completed = parent.tasks_completed;
+    Reset();
+    Mutate(mutation_rate);
   }
 
   /**
@@ -78,10 +89,11 @@ public:
    * location and other factors.
    * 
    * @param current_location The organism's current location in the world.
+   * @param n_cycles The number of CPU cycles to run.
    */
-  void Process(emp::WorldPosition current_location) {
+  void Process(emp::WorldPosition current_location, size_t n_cycles) {
     cpu.state.current_location = current_location;
-    cpu.RunCPUStep(10);
+    cpu.RunCPUStep(n_cycles);
   }
 
   /// Print this organism’s genome to the standard output.
@@ -1,27 +1,118 @@
 #ifndef ORGSTATE_H
 #define ORGSTATE_H
 
+#include "HotState.h"
+#include "InputStream.h"
 #include "emp/Evolve/World_structure.hpp"
 #include <cstddef>
+#include <cstdint>
 
 /// Forward declaration to avoid cyclic dependency with OrgWorld.
 class OrgWorld;
 
 /// Stores the internal state of an organism, including fitness, location, and recent inputs.
+///
+/// While the organism is placed in a world, its points, last task and inputs
+/// live in the world's HotStateStore at the organism's cell; otherwise (e.g.
+/// a newly built offspring) they are kept in this object. Copying a state
+/// copies the values, never the attachment or the input stream: a copy is a
+/// new organism and gets its own stream when it is placed.
+///
+/// Organisms don't point back to their world. OrgWorld makes itself the
+/// current world of each thread that runs its organisms (see WorldScope),
+/// and instructions reach it through World().
 struct OrgState {
-  emp::Ptr<OrgWorld> world;             ///< Pointer to the simulation world.
-
-  float last_inputs[4];                 ///< Circular buffer of the 4 most recent input values.
-  size_t last_input_idx = 0;            ///< Index of the most recent input in the buffer.
-  double points = 0.0;                  ///< Fitness or score for the organism.
   emp::WorldPosition current_location;  ///< Current position in the world.
+  InputStream input_stream;             ///< Where this organism's inputs come from.
+
+private:
+  inline static thread_local OrgWorld *current_world = nullptr;
+
+  emp::Ptr<HotStateStore> store = nullptr;  ///< Where the values live while placed.
+  uint32_t cell = 0;                        ///< Index into store while placed.
+
+  // Values used while the organism is not placed in a world.
+  int8_t own_last_task_completed = -1;
+  uint8_t own_input_idx = 0;
+  double own_points = 0.0;
+  uint32_t own_inputs[4] = {};
+
+  void CopyValuesFrom(const OrgState &other) {
+    Points() = other.Points();
+    LastTaskCompleted() = other.LastTaskCompleted();
+    for (size_t i = 0; i < 4; i++) Inputs()[i] = other.Inputs()[i];
+    InputIdx() = other.InputIdx();
+  }
 
-  int last_task_completed = -1;         ///< Last completed task ID; -1 means none.
+public:
+  /// Makes a world the current world of this thread for the length of a scope.
+  class WorldScope {
+    OrgWorld *previous;
+
+  public:
+    explicit WorldScope(OrgWorld *world) : previous(current_world) { current_world = world; }
+    ~WorldScope() { current_world = previous; }
+    WorldScope(const WorldScope &) = delete;
+    WorldScope &operator=(const WorldScope &) = delete;
+  };
+
+  /// The world whose organisms this thread is running.
+  static OrgWorld &World() { return *current_world; }
+
+  OrgState() = default;
+
+  OrgState(const OrgState &other) : current_location(other.current_location) {
+    CopyValuesFrom(other);
+  }
+
+  OrgState &operator=(const OrgState &other) {
+    current_location = other.current_location;
+    CopyValuesFrom(other);
+    return *this;
+  }
+
+  /// Fitness or score for the organism.
+  double &Points() { return store ? store->points[cell] : own_points; }
+  double Points() const { return store ? store->points[cell] : own_points; }
+
+  /// Last completed task ID; -1 means none.
+  int8_t &LastTaskCompleted() { return store ? store->last_task_completed[cell] : own_last_task_completed; }
+  int8_t LastTaskCompleted() const { return store ? store->last_task_completed[cell] : own_last_task_completed; }
+
+  /// Circular buffer of the 4 most recent input values.
+  uint32_t *Inputs() { return store ? store->last_inputs[cell].data() : own_inputs; }
+  const uint32_t *Inputs() const { return store ? store->last_inputs[cell].data() : own_inputs; }
+
+  /// Index of the most recent input in the buffer.
+  uint8_t &InputIdx() { return store ? store->last_input_idx[cell] : own_input_idx; }
+  uint8_t InputIdx() const { return store ? store->last_input_idx[cell] : own_input_idx; }
+
+  /// Move the values into a world's store at the given cell.
+  void Attach(emp::Ptr<HotStateStore> new_store, size_t new_cell) {
+    Detach();
+    new_store->points[new_cell] = own_points;
+    new_store->last_task_completed[new_cell] = own_last_task_completed;
+    for (size_t i = 0; i < 4; i++) new_store->last_inputs[new_cell][i] = own_inputs[i];
+    new_store->last_input_idx[new_cell] = own_input_idx;
+    store = new_store;
+    cell = new_cell;
+  }
+
+  /// Copy the values back out of the world's store.
+  void Detach() {
+    if (!store) return;
+    own_points = store->points[cell];
+    own_last_task_completed = store->last_task_completed[cell];
+    for (size_t i = 0; i < 4; i++) own_inputs[i] = store->last_inputs[cell][i];
+    own_input_idx = store->last_input_idx[cell];
+    store = nullptr;
+  }
 
   /// Add a new input to the circular buffer of recent inputs.
   void add_input(uint32_t input) {
-    last_inputs[last_input_idx] = static_cast<float>(input);
-    last_input_idx = (last_input_idx + 1) % 4;
+    uint8_t &idx = InputIdx();
+    Inputs()[idx] = input;
+    idx = (idx + 1) % 4;
   }
 };
 
@@ -0,0 +1,193 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sgpl/hardware/Core.hpp"
+#include "sgpl/program/Instruction.hpp"
+#include "sgpl/program/Program.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// Hot-path instrumentation, compiled in with -DENABLE_PROFILING.
+///
+/// Counters are plain integers in a Counters block. Each thread adds to the
+/// block its `current` pointer names, so threads never share a counter and
+/// OrgWorld can give every chunk its own block and merge them afterwards,
+/// like its reproduction queues. Time counters hold raw clock ticks and are
+/// converted to nanoseconds only when a report row is written.
+///
+/// Without ENABLE_PROFILING the PROFILE_* macros expand to nothing and
+/// PROFILED_OP(op) is just op, so none of this is compiled into the hot path.
+namespace profiler {
+
+/// Counters every world reports, in file order. Per-op counters follow.
+enum Counter : size_t {
+  UPDATE_TIME,           ///< All of OrgWorld::Update.
+  STATS_TIME,            ///< The shared statistics pass.
+  PROCESS_TIME,          ///< Running every organism's CPU (includes task checks).
+  CHECK_OUTPUT_TIME,     ///< OrgWorld::CheckOutput, summed over threads.
+  REPRODUCE_QUEUE_TIME,  ///< Walking the reproduce queue (includes births).
+  BIRTH_TIME,            ///< Building and placing offspring.
+  MOVE_TIME,             ///< The movement phase.
+  CHECK_OUTPUT_CALLS,
+  BIRTHS,
+  DEATHS,
+  ALLOCATIONS,           ///< New organisms and cloned genomes.
+  NUM_FIXED_COUNTERS
+};
+
+constexpr size_t NUM_TIME_COUNTERS = CHECK_OUTPUT_CALLS;
+constexpr size_t MAX_COUNTERS = 64;
+
+/// One block of counters.
+struct Counters {
+  std::array<uint64_t, MAX_COUNTERS> values{};
+
+  void Merge(const Counters &other) {
+    for (size_t i = 0; i < MAX_COUNTERS; i++) values[i] += other.values[i];
+  }
+  void Clear() { values.fill(0); }
+};
+
+/// The block this thread is adding to, if any.
+inline thread_local Counters *current = nullptr;
+
+inline void Add(size_t counter, uint64_t amount = 1) {
+  if (current) current->values[counter] += amount;
+}
+
+/// @return Names of all counters, fixed ones first.
+inline std::vector<std::string> &Names() {
+  static std::vector<std::string> names{
+      "update_ns", "stats_ns", "process_ns", "check_output_ns", "reproduce_queue_ns",
+      "birth_ns", "move_ns", "check_output_calls", "births", "deaths", "allocations"};
+  return names;
+}
+
+/// Registers one more counter; only called during static initialization.
+inline size_t AddCounter(const std::string &name) {
+  if (Names().size() == MAX_COUNTERS) throw std::length_error("Too many profiling counters");
+  Names().push_back(name);
+  return Names().size() - 1;
+}
+
+/// @return A cheap, monotonic tick count (the CPU timestamp counter where available).
+inline uint64_t Now() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/// @return Nanoseconds per tick of Now(), measured once against steady_clock.
+inline double NsPerTick() {
+  static const double ns_per_tick = [] {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    uint64_t start_ticks = Now();
+    while (clock::now() - start < std::chrono::milliseconds(20)) {
+    }
+    double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    uint64_t ticks = Now() - start_ticks;
+    return ticks ? ns / ticks : 1.0;
+  }();
+  return ns_per_tick;
+}
+
+/// Adds the ticks spent in a scope to a time counter.
+class ScopedTimer {
+  size_t counter;
+  uint64_t start;
+
+public:
+  explicit ScopedTimer(size_t counter) : counter(counter), start(Now()) {}
+  ~ScopedTimer() { Add(counter, Now() - start); }
+};
+
+/// Points this thread's `current` at a block for the length of a scope.
+class UseCounters {
+  Counters *previous;
+
+public:
+  explicit UseCounters(Counters &counters) : previous(current) { current = &counters; }
+  ~UseCounters() { current = previous; }
+};
+
+/// @return "op_" followed by an op name with spaces replaced, as a column name.
+inline std::string OpCounterName(std::string name) {
+  for (char &c : name) if (c == ' ') c = '_';
+  return "op_" + name;
+}
+
+/// Wraps an instruction so every execution is counted under "op_<name>".
+template <typename Op>
+struct ProfiledOp {
+  inline static const size_t counter = AddCounter(OpCounterName(Op::name()));
+
+  template <typename Spec>
+  static void run(sgpl::Core<Spec> &core, const sgpl::Instruction<Spec> &inst,
+                  const sgpl::Program<Spec> &program,
+                  typename Spec::peripheral_t &peripheral) noexcept {
+    Add(counter);
+    Op::template run<Spec>(core, inst, program, peripheral);
+  }
+
+  static std::string name() { return Op::name(); }
+  static size_t prevalence() { return Op::prevalence(); }
+};
+
+/// Writes one CSV row of counters per update.
+class Report {
+  std::ofstream out;
+  bool header_written = false;
+
+public:
+  explicit Report(const std::string &filename) : out(filename) {}
+
+  /// @param update The update the counters were collected over.
+  /// @param counters The totals for that update.
+  void Write(size_t update, const Counters &counters) {
+    const std::vector<std::string> &names = Names();
+    if (!header_written) {
+      out << "update";
+      for (const std::string &name : names) out << ',' << name;
+      out << '\n';
+      header_written = true;
+    }
+    out << update;
+    for (size_t i = 0; i < names.size(); i++) {
+      if (i < NUM_TIME_COUNTERS) out << ',' << static_cast<uint64_t>(counters.values[i] * NsPerTick());
+      else out << ',' << counters.values[i];
+    }
+    out << '\n';
+  }
+};
+
+} // namespace profiler
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_SCOPE(counter) profiler::ScopedTimer PROFILE_CONCAT(profile_timer_, __LINE__)(counter)
+#define PROFILE_COUNT(counter, amount) profiler::Add(counter, amount)
+#define PROFILED_OP(op) profiler::ProfiledOp<op>
+#else
+#define PROFILE_SCOPE(counter)
+#define PROFILE_COUNT(counter, amount)
+#define PROFILED_OP(op) op
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,146 @@
+#ifndef REPLICATESUMMARY_H
+#define REPLICATESUMMARY_H
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Streaming mean, standard deviation and 95% confidence interval of every
+/// data file column, per treatment and update, across concurrently running
+/// replicates, so no per-seed files are needed to summarize a sweep. Rows are
+/// folded in as they arrive (Welford's algorithm), always in replicate order:
+/// a row that arrives before the earlier replicates' rows for the same update
+/// waits until they do. Only rows of replicates running ahead are held, so the
+/// summary doesn't depend on which replicate finished first or on how many
+/// threads ran them.
+class ReplicateSummary {
+public:
+  /// Welford's running mean and sum of squared deviations.
+  struct RunningStats {
+    size_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void Add(double x) {
+      n++;
+      double delta = x - mean;
+      mean += delta / n;
+      m2 += delta * (x - mean);
+    }
+
+    double Variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double StdDev() const { return std::sqrt(Variance()); }
+
+    /// Half-width of the 95% confidence interval of the mean.
+    double CI95() const { return n > 1 ? TCritical95(n - 1) * StdDev() / std::sqrt(n) : 0.0; }
+  };
+
+  /// Two-sided 95% critical value of Student's t distribution.
+  /// @param df Degrees of freedom (at least 1).
+  static double TCritical95(size_t df) {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df >= 1 && df <= 30) return table[df - 1];
+    // First Cornish-Fisher correction to the normal quantile
+    return 1.959964 + 2.372 / df;
+  }
+
+private:
+  struct Row {
+    size_t reps = 0;                 ///< Replicates folded in so far.
+    std::vector<RunningStats> stats; ///< One per metric.
+    size_t next_rep = 0;             ///< Replicate whose row is folded in next.
+    std::map<size_t, std::vector<double>> pending;  ///< Later replicates' rows, by replicate.
+
+    /// Fold one replicate's values into the statistics, skipping NaN values
+    /// (e.g. a mean over no data).
+    void Fold(const std::vector<double> &values, size_t num_metrics) {
+      if (stats.empty()) stats.resize(num_metrics);
+      reps++;
+      for (size_t i = 0; i < values.size() && i < stats.size(); i++) {
+        if (!std::isnan(values[i])) stats[i].Add(values[i]);
+      }
+    }
+  };
+
+  std::vector<std::string> treatments;           ///< Label of each treatment.
+  std::vector<std::string> metrics;              ///< Column names being summarized.
+  std::vector<std::map<size_t, Row>> rows;       ///< Per treatment, keyed by update.
+  std::mutex mutex;
+
+public:
+  /// @param treatment_labels One label per treatment, printed in the treatment column.
+  explicit ReplicateSummary(std::vector<std::string> treatment_labels)
+      : treatments(std::move(treatment_labels)), rows(treatments.size()) {}
+
+  /// Name the metrics that Add() will receive, in order. Every replicate
+  /// calls this; only the first call has an effect.
+  void SetMetrics(const std::vector<std::string> &names) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (metrics.empty()) metrics = names;
+  }
+
+  /// Fold one replicate's sampled row into the running statistics, or hold
+  /// it until every earlier replicate's row for this update is in.
+  /// @param treatment Index of the replicate's treatment.
+  /// @param replicate Index of the replicate within its treatment.
+  /// @param update The update the values were sampled at.
+  /// @param values One value per metric.
+  void Add(size_t treatment, size_t replicate, size_t update, const std::vector<double> &values) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Row &row = rows[treatment][update];
+    if (replicate != row.next_rep) {
+      row.pending[replicate] = values;
+      return;
+    }
+    row.Fold(values, metrics.size());
+    row.next_rep++;
+    for (auto next = row.pending.begin(); next != row.pending.end() && next->first == row.next_rep;
+         next = row.pending.erase(next)) {
+      row.Fold(next->second, metrics.size());
+      row.next_rep++;
+    }
+  }
+
+  /// Write the summary as a space-separated table, one row per treatment
+  /// and update, with mean, sd and ci95 columns for each metric. Call it
+  /// once every replicate has finished; rows still held because an earlier
+  /// replicate never sampled that update (e.g. it resumed past it) are
+  /// folded in first, in replicate order.
+  /// @param filename Where to write the table.
+  void Write(const std::string &filename) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::map<size_t, Row> &treatment_rows : rows) {
+      for (auto &[update, row] : treatment_rows) {
+        for (const auto &[replicate, values] : row.pending) row.Fold(values, metrics.size());
+        row.pending.clear();
+      }
+    }
+
+    std::ofstream out(filename);
+    out << "treatment update reps";
+    for (const std::string &metric : metrics) {
+      out << ' ' << metric << "_mean " << metric << "_sd " << metric << "_ci95";
+    }
+    out << '\n';
+
+    for (size_t t = 0; t < treatments.size(); t++) {
+      for (const auto &[update, row] : rows[t]) {
+        out << treatments[t] << ' ' << update << ' ' << row.reps;
+        for (const RunningStats &stats : row.stats) {
+          out << ' ' << stats.mean << ' ' << stats.StdDev() << ' ' << stats.CI95();
+        }
+        out << '\n';
+      }
+    }
+  }
+};
+
+#endif // REPLICATESUMMARY_H
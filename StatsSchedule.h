@@ -0,0 +1,64 @@
+#ifndef STATSSCHEDULE_H
+#define STATSSCHEDULE_H
+
+#include "ConfigSetup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/// Which updates statistics are gathered and written on.
+///
+/// EVERY samples every `interval` updates. LOG samples `interval` updates
+/// per decade: update 0, then the first update in each interval-th of a
+/// power of ten, so rows thin out as a long run goes on. FINAL samples only
+/// the last update. LOG and FINAL always include the last update. Every
+/// mode is a pure function of the update number, so a resumed run samples
+/// the same updates as an uninterrupted one.
+struct StatsSchedule {
+  enum Mode { EVERY, LOG, FINAL };
+
+  Mode mode = EVERY;
+  size_t interval = 1;      ///< EVERY: updates between samples. LOG: samples per decade.
+  size_t last_update = 0;   ///< The final update of the run, for LOG and FINAL.
+
+  /// Sets the mode from an OUTPUT_SCHEDULE name.
+  /// @param name "every", "log" or "final".
+  void SetMode(const std::string &name) {
+    if (name == "every") mode = EVERY;
+    else if (name == "log") mode = LOG;
+    else if (name == "final") mode = FINAL;
+    else throw std::invalid_argument("Unknown output schedule: " + name);
+  }
+
+  bool IsSampled(size_t update) const {
+    switch (mode) {
+    case EVERY:
+      return update % std::max<size_t>(interval, 1) == 0;
+    case LOG:
+      return update <= 1 || update == last_update || LogBucket(update) != LogBucket(update - 1);
+    case FINAL:
+      return update == last_update;
+    }
+    return false;
+  }
+
+  /// @return The schedule in a loaded configuration.
+  static StatsSchedule FromConfig(const MyConfigType &config) {
+    StatsSchedule schedule;
+    schedule.SetMode(config.OUTPUT_SCHEDULE());
+    schedule.interval = std::max(config.OUTPUT_INTERVAL(), 1);
+    schedule.last_update = std::max(config.NUM_UPDATES(), 1) - 1;
+    return schedule;
+  }
+
+private:
+  long LogBucket(size_t update) const {
+    // The small offset keeps exact powers of ten from rounding down a bucket
+    return static_cast<long>(std::floor(interval * std::log10(double(update)) + 1e-9));
+  }
+};
+
+#endif // STATSSCHEDULE_H
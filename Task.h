@@ -1,175 +1,133 @@
 #ifndef TASK_H
 #define TASK_H
 
-#include <cmath>
-#include <string>
-#include <iostream>
-
-/// Converts a float to a boolean.
-/// Considers any non-zero value as true.
-bool toBool(float x) {
-    return std::fabs(x) > 0.001;
-}
-
-/// Converts a boolean to a float.
-/// Returns 1.0f for true, 0.0f for false.
-float toFloat(bool b) {
-    return b ? 1.0f : 0.0f;
-}
-
-/// Abstract base class for all task types.
-/// Defines the interface that all task types must implement to check outputs and return task names.
-class Task {
-public:
-    /// Checks if the output is correct for a given set of inputs.
-    /// @param output The output to check.
-    /// @param inputs The input values for the task.
-    /// @return A score indicating correctness (e.g., 1.0 for correct, 0.0 for incorrect).
-    virtual double CheckOutput(float output, float inputs[4]) = 0;
-
-    /// Returns the name of the task.
-    /// @return The name of the task as a string.
-    virtual std::string name() const = 0;
-};
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Every task is a logic function of the organism's four most recent inputs,
+/// computed bitwise over all 32 bits. An output solves a task only when it
+/// matches the task's result exactly.
+///
+/// Each task type provides:
+///   name   - label used in output files
+///   reward - points for solving it (0 means it is tracked but never paid)
+///   Eval() - the expected output for the given inputs
 
 // NOT Gate: Inverts the input.
-class NOT : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool input = toBool(inputs[0]);
-        bool result = !input;
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "NOT";
-    }
+struct NOT {
+    static constexpr const char *name = "NOT";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return ~in[0]; }
 };
 
 // NAND Gate: Outputs true unless both inputs are true.
-class NAND : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = !(toBool(inputs[0]) && toBool(inputs[1]));
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "NAND";
-    }
+struct NAND {
+    static constexpr const char *name = "NAND";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return ~(in[0] & in[1]); }
 };
 
 // AND Gate: Outputs true only if both inputs are true.
-class AND : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = toBool(inputs[0]) && toBool(inputs[1]);
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "AND";
-    }
+struct AND {
+    static constexpr const char *name = "AND";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return in[0] & in[1]; }
 };
 
 // OR_N Gate: Multi-input OR (true if any input is true).
-class OR_N : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = false;
-        for (int i = 0; i < 4; ++i) {
-            result = result || toBool(inputs[i]);
-        }
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "OR_N";
-    }
+struct OR_N {
+    static constexpr const char *name = "OR_N";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return in[0] | in[1] | in[2] | in[3]; }
 };
 
 // OR Gate: Outputs true if at least one of the two inputs is true.
-class OR : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = toBool(inputs[0]) || toBool(inputs[1]);
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "OR";
-    }
+struct OR {
+    static constexpr const char *name = "OR";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return in[0] | in[1]; }
 };
 
 // AND_N Gate: Multi-input AND (true only if all inputs are true).
-class AND_N : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = true;
-        for (int i = 0; i < 4; ++i) {
-            result = result && toBool(inputs[i]);
-        }
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "AND_N";
-    }
+struct AND_N {
+    static constexpr const char *name = "AND_N";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return in[0] & in[1] & in[2] & in[3]; }
 };
 
 // NOR Gate: Outputs true only if both inputs are false.
-class NOR : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = !(toBool(inputs[0]) || toBool(inputs[1]));
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "NOR";
-    }
+struct NOR {
+    static constexpr const char *name = "NOR";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return ~(in[0] | in[1]); }
 };
 
 // XOR Gate: Outputs true if inputs are different.
-class XOR : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = toBool(inputs[0]) ^ toBool(inputs[1]);
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "XOR";
-    }
+struct XOR {
+    static constexpr const char *name = "XOR";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return in[0] ^ in[1]; }
 };
 
 // EQU Gate: Logical equivalence (XNOR), outputs true if inputs are the same.
-class EQU : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool result = !(toBool(inputs[0]) ^ toBool(inputs[1]));
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 0.0 : 0.0;
-    }
-
-    std::string name() const override {
-        return "EQU";
-    }
+struct EQU {
+    static constexpr const char *name = "EQU";
+    static constexpr double reward = 0.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return ~(in[0] ^ in[1]); }
 };
 
 // COMPLEX: (A AND B) OR (C AND D)
-class COMPLEX : public Task {
-public:
-    double CheckOutput(float output, float inputs[4]) override {
-        bool ab = toBool(inputs[0]) && toBool(inputs[1]);
-        bool cd = toBool(inputs[2]) && toBool(inputs[3]);
-        bool result = ab || cd;
-        return (std::fabs(output - toFloat(result)) < 0.001) ? 64.0 : 0.0;
-    }
+struct COMPLEX {
+    static constexpr const char *name = "COMPLEX";
+    static constexpr double reward = 64.0;
+    static constexpr uint32_t Eval(const uint32_t in[4]) { return (in[0] & in[1]) | (in[2] & in[3]); }
+};
 
-    std::string name() const override {
-        return "COMPLEX";
+/// A compile-time table of tasks, indexed in the order they are listed.
+/// Every check is inlined, so scoring an output is a few compares and ORs.
+template <typename... TASKS>
+struct TaskSet {
+    static_assert(sizeof...(TASKS) <= 32, "Task masks are 32 bits wide");
+
+    static constexpr size_t size = sizeof...(TASKS);
+    static constexpr std::array<const char *, size> names{TASKS::name...};
+    static constexpr std::array<double, size> rewards{TASKS::reward...};
+
+    /// Bit i is set when task i pays a positive reward.
+    static constexpr uint32_t paying_mask = [] {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < size; ++i) {
+            if (rewards[i] > 0.0) mask |= uint32_t(1) << i;
+        }
+        return mask;
+    }();
+
+    /// Checks an output against every task at once.
+    /// @param output The value the organism produced.
+    /// @param inputs The organism's four most recent inputs.
+    /// @return A mask with bit i set when the output solves task i.
+    static uint32_t Match(uint32_t output, const uint32_t inputs[4]) {
+        uint32_t mask = 0;
+        size_t i = 0;
+        ((mask |= uint32_t(output == TASKS::Eval(inputs)) << i++), ...);
+        return mask;
+    }
+
+    /// Picks the solved task with the largest reward; ties go to the lower index.
+    /// @param solved A mask returned by Match().
+    /// @return The index of the best paying task, or -1 if none pays.
+    static int Best(uint32_t solved) {
+        solved &= paying_mask;
+        int best = -1;
+        for (size_t i = 0; solved; ++i, solved >>= 1) {
+            if ((solved & 1) && (best < 0 || rewards[i] > rewards[best])) best = i;
+        }
+        return best;
     }
 };
 
+/// The tasks rewarded in this world, in output-column order.
+using Tasks = TaskSet<NOT, NAND, AND, OR_N, OR, AND_N, NOR, XOR, EQU, COMPLEX>;
 
 #endif // TASK_H
@@ -0,0 +1,221 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A fixed set of worker threads that split a loop of independent chunks.
+/// The calling thread also takes chunks, so a pool of N threads spawns N-1
+/// workers and a pool of 1 thread simply runs the loop inline.
+class ThreadPool {
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;  ///< Signals workers that a new loop started.
+  std::condition_variable done;  ///< Signals the caller that workers are idle.
+
+  const std::function<void(size_t)> *job = nullptr;  ///< Body of the current loop.
+  size_t num_chunks = 0;
+  std::atomic<size_t> next_chunk{0};
+  size_t busy = 0;        ///< Workers that have not finished the current loop.
+  size_t generation = 0;  ///< Incremented every time a new loop starts.
+  bool stopping = false;
+
+  /// Claim chunks until none are left.
+  void RunChunks() {
+    for (size_t chunk = next_chunk++; chunk < num_chunks; chunk = next_chunk++) {
+      (*job)(chunk);
+    }
+  }
+
+  /// Body of each worker thread: sleep until a loop starts, help with it,
+  /// then report back.
+  void WorkerLoop() {
+    size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+      lock.unlock();
+      RunChunks();
+      lock.lock();
+      if (--busy == 0) done.notify_one();
+    }
+  }
+
+public:
+  /// @param num_threads Total threads to use, including the calling thread.
+  explicit ThreadPool(size_t num_threads) {
+    for (size_t i = 1; i < num_threads; i++) {
+      workers.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) worker.join();
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// @return Total number of threads, including the calling thread.
+  size_t GetNumThreads() const { return workers.size() + 1; }
+
+  /// Run fun(0) ... fun(n-1) across the pool and return once all are done.
+  /// Chunks may run in any order and on any thread.
+  /// @param n Number of chunks.
+  /// @param fun Chunk body; must be safe to call concurrently for different chunks.
+  void ParallelFor(size_t n, const std::function<void(size_t)> &fun) {
+    if (workers.empty() || n <= 1) {
+      for (size_t i = 0; i < n; i++) fun(i);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = &fun;
+      num_chunks = n;
+      next_chunk = 0;
+      busy = workers.size();
+      generation++;
+    }
+    wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return busy == 0; });
+    job = nullptr;
+  }
+};
+
+/// A pool of worker threads for independent, long-running tasks of uneven
+/// length. Each worker owns a deque: it takes its own work from the back and,
+/// when empty, steals from the front of the other workers' deques.
+class WorkStealingPool {
+  using task_t = std::function<void()>;
+
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<task_t> tasks;
+  };
+
+  std::vector<std::unique_ptr<TaskQueue>> queues;  ///< One per worker.
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable wake;      ///< Signals workers that tasks arrived.
+  std::condition_variable all_done;  ///< Signals Wait() that the pool drained.
+  size_t queued = 0;                 ///< Tasks submitted but not yet claimed.
+  size_t pending = 0;                ///< Tasks submitted but not yet finished.
+  size_t next_queue = 0;             ///< Round-robin target for Submit().
+  bool stopping = false;
+
+  /// Take a task from the back of a worker's own deque.
+  bool TryPop(size_t self, task_t &task) {
+    TaskQueue &queue = *queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+  }
+
+  /// Take a task from the front of some other worker's deque.
+  bool TrySteal(size_t self, task_t &task) {
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+      TaskQueue &queue = *queues[(self + offset) % queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) continue;
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  void WorkerLoop(size_t self) {
+    while (true) {
+      task_t task;
+      if (TryPop(self, task) || TrySteal(self, task)) {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          queued--;
+        }
+        task();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) all_done.notify_all();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || queued > 0; });
+      if (stopping && queued == 0) return;
+    }
+  }
+
+public:
+  /// @param num_threads Number of worker threads (at least one is started).
+  explicit WorkStealingPool(size_t num_threads) {
+    if (num_threads == 0) num_threads = 1;
+    for (size_t i = 0; i < num_threads; i++) {
+      queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < num_threads; i++) {
+      workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  /// Finishes every submitted task, then stops the workers.
+  ~WorkStealingPool() {
+    Wait();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) worker.join();
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  /// @return Number of worker threads.
+  size_t GetNumThreads() const { return workers.size(); }
+
+  /// Queue a task; it will run on one of the workers.
+  void Submit(task_t task) {
+    size_t target;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      target = next_queue++ % queues.size();
+      pending++;
+      queued++;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues[target]->mutex);
+      queues[target]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+  }
+
+  /// Block until every submitted task has finished.
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [&] { return pending == 0; });
+  }
+};
+
+#endif // THREADPOOL_H
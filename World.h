@@ -6,17 +6,170 @@
 #include "emp/math/Random.hpp"
 #include "Task.h"
 #include "Org.h"
-#include "ConfigSetup.h"
+#include "WorldParams.h"
+#include "ThreadPool.h"
+#include "HotState.h"
+#include "ColumnarFile.h"
+#include "AsyncWriter.h"
+#include "Checkpoint.h"
+#include "Profiler.h"
+#include "MeritSampler.h"
+#include "InputStream.h"
+#include "BirthQueue.h"
+#include "StatsSchedule.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 
+/// Holds the stream of an OrgDataFile. As the first base it is built before,
+/// and destroyed after, the emp::DataFile that writes to it.
+struct DataFileStream {
+  std::ofstream stream;
+};
+
+/// An emp::DataFile with its own stream, so the file can be appended to
+/// when a run resumes and flushed when a checkpoint is saved.
+class OrgDataFile : private DataFileStream, public emp::DataFile {
+public:
+  OrgDataFile(const std::string & filename, bool append)
+      : DataFileStream{std::ofstream(filename, append ? std::ios::app : std::ios::out)},
+        emp::DataFile(stream) {}
+
+  void Flush() { stream.flush(); }
+};
+
 class OrgWorld : public emp::World<Organism> {
   emp::Random &random;
-  std::vector<emp::WorldPosition> reproduce_queue;
+  BirthQueue birth_queue;  ///< Cells asking to reproduce this update.
+  emp::vector<size_t> schedule;  ///< Order cells are visited in this update.
+
+  /// Organisms that died, kept so their storage can be reused for offspring.
+  std::vector<emp::Ptr<Organism>> org_pool;
+
+  /// Points, last task and inputs of every placed organism, indexed by cell.
+  HotStateStore hot;
+
+  // Organisms are processed in fixed-size slices of the schedule so that the
+  // merge order never depends on how many threads are running.
+  static constexpr size_t CHUNK_SIZE = 256;
+
+  WorldParams params;        ///< Settings for the current update; never changed mid-update.
+  std::optional<WorldParams> staged_params;  ///< Replaces params before the next update.
+  std::mutex staged_params_mutex;
+  MeritSampler merit_sampler;
+  uint64_t input_seed = 0;   ///< Key of every organism's input stream.
+  uint64_t last_org_id = 0;  ///< ID given to the most recently placed new organism.
+
+  // Movement phase buffers, kept between updates
+  static constexpr uint32_t NO_MOVE = UINT32_MAX;
+  std::vector<uint32_t> move_targets;  ///< Cell each occupied-index entry wants, or NO_MOVE.
+  std::vector<uint64_t> move_keys;     ///< Its claim on that cell; the lowest claim wins.
+  std::unique_ptr<std::atomic<uint64_t>[]> move_claims;  ///< Lowest claim on each cell.
+  size_t move_claims_size = 0;
+  std::vector<std::pair<uint32_t, uint32_t>> moves;      ///< Winning (from, to) pairs.
+  size_t num_threads = 0;  ///< 0 runs the classic serial update.
+  std::unique_ptr<ThreadPool> pool;
+  std::vector<std::vector<uint32_t>> chunk_reproduce_queues;
+
+  /// An extra metric filled during the shared statistics pass.
+  struct StatsStage {
+    std::function<void()> reset;
+    std::function<void(Organism &)> add;
+  };
+  std::vector<StatsStage> stats_stages;
+  std::vector<std::unique_ptr<columnar::Writer>> columnar_files;
+  std::vector<std::unique_ptr<AsyncCsvWriter>> async_files;
+
+  /// A data file whose size checkpoints record.
+  struct DataOutput {
+    std::string filename;
+    std::function<void()> flush;  ///< Writes out every row buffered so far.
+  };
+  std::vector<DataOutput> data_outputs;
+  std::vector<uint64_t> resume_data_sizes;  ///< Data file sizes in the loaded checkpoint.
+  StatsSchedule stats_schedule;  ///< Updates statistics are gathered on.
+  size_t stats_flag_update = SIZE_MAX;  ///< Update stats_flag was computed for.
+  bool stats_flag = false;              ///< Whether stats_flag_update is sampled.
+  bool stats_registered = false; ///< Whether the statistics pass is hooked into OnUpdate.
+
+#ifdef ENABLE_PROFILING
+  profiler::Counters profile_counters;               ///< Totals since the last profile row.
+  std::vector<profiler::Counters> chunk_profile_counters;
+  std::unique_ptr<profiler::Report> profile_report;
+#endif
+
+  /**
+   * @brief Hooks the shared statistics pass into OnUpdate the first time it is needed
+   */
+  void SetupStatsCollector() {
+    if (stats_registered) return;
+    stats_registered = true;
+    OnUpdate([this](size_t update) { CollectStats(update); });
+  }
+
+  /**
+   * @brief Registers a data file, picking up where a resumed run left it
+   * 
+   * After a full LoadCheckpoint, data files set up in the same order as
+   * before are cut back to their size when the checkpoint was saved, which
+   * drops rows written after it, and appended to. Set the returned entry's
+   * flush once the file is open.
+   * 
+   * @param filename The data file.
+   * @return Whether to append to the existing file instead of starting anew.
+   */
+  bool AddDataOutput(const std::string & filename) {
+    const size_t index = data_outputs.size();
+    data_outputs.push_back({filename, [] {}});
+    if (index >= resume_data_sizes.size()) return false;
+
+    std::error_code error;
+    const uintmax_t size = std::filesystem::file_size(filename, error);
+    if (error || size < resume_data_sizes[index]) return false;  // Missing or short: start over
+    std::filesystem::resize_file(filename, resume_data_sizes[index]);
+    return true;
+  }
+
+  /**
+   * @brief Moves the organism at from into the empty cell to
+   * 
+   * Its hot state and place in the occupied index move with it; the
+   * population count is unchanged and no placement or death signals fire.
+   */
+  void RelocateOrg(size_t from, size_t to) {
+    emp::Ptr<Organism> org = pop[from];
+    org->cpu.state.Attach(&hot, to);
+    org->cpu.state.current_location = emp::WorldPosition(to);
+    hot.occupied.Erase(from);
+    hot.occupied.Insert(to);
+    pop[from] = nullptr;
+    pop[to] = org;
+  }
+
+  /// Reproduction requests made on this thread while it is processing a chunk.
+  inline static thread_local std::vector<uint32_t> *local_reproduce_queue = nullptr;
 
 public:
+  /// One column of the organism data file, for outputs other than emp::DataFile.
+  struct OrgColumn {
+    std::string name;
+    std::string desc;
+    columnar::ColumnType type;
+    std::function<double()> get;
+  };
+
   // Add the DataMonitor pointer for the organism count
   emp::Ptr<emp::DataMonitor<int>> org_count;
 
@@ -26,28 +179,30 @@ public:
   // Add
   emp::Ptr<emp::DataMonitor<int, emp::data::Histogram>> tasks_completed_monitor;
 
-  // Store tasks using smart pointers to avoid memory leaks
-  std::vector<std::unique_ptr<Task>> tasks;
-
   /**
    * @brief Construct a new OrgWorld object
    * 
-   * Initializes the world with a random number generator and sets up the task list.
+   * Initializes the world with a random number generator.
    * 
    * @param _random Random number generator for the world.
+   * @param _params Settings to run with, e.g. WorldParams::FromConfig(config).
    */
-  OrgWorld(emp::Random &_random) : emp::World<Organism>(_random), random(_random) {
-    MyConfigType config;
-    tasks.push_back(std::make_unique<NOT>());
-    tasks.push_back(std::make_unique<NAND>());
-    tasks.push_back(std::make_unique<AND>());
-    tasks.push_back(std::make_unique<OR_N>());
-    tasks.push_back(std::make_unique<OR>());
-    tasks.push_back(std::make_unique<AND_N>());
-    tasks.push_back(std::make_unique<NOR>());
-    tasks.push_back(std::make_unique<XOR>());
-    tasks.push_back(std::make_unique<EQU>());
-    tasks.push_back(std::make_unique<COMPLEX>());
+  OrgWorld(emp::Random &_random, const WorldParams &_params = WorldParams{})
+      : emp::World<Organism>(_random), random(_random), params(_params) {
+
+    OnPlacement([this](size_t pos) {
+      if (hot.size() < pop.size()) hot.Resize(pop.size());
+      pop[pos]->cpu.state.Attach(&hot, pos);
+      hot.occupied.Insert(pos);
+      // New organisms get an ID and input stream; moved ones keep theirs
+      if (!pop[pos]->cpu.state.input_stream.IsStarted()) {
+        pop[pos]->cpu.StartInputStream(input_seed, ++last_org_id);
+      }
+    });
+    OnOrgDeath([this](size_t pos) {
+      hot.occupied.Erase(pos);
+      PROFILE_COUNT(profiler::DEATHS, 1);
+    });
   }
 
   /**
@@ -56,12 +211,16 @@ public:
    * Cleans up the DataMonitor objects to prevent memory leaks.
    */
   ~OrgWorld() {
+    for (emp::Ptr<Organism> org : org_pool) org.Delete();
     if (org_count) {
       org_count.Delete();  // Deallocate the DataMonitor if it exists
     }
     if (point_count) {
       point_count.Delete();  // Deallocate the DataMonitor if it exists
     }
+    if (tasks_completed_monitor) {
+      tasks_completed_monitor.Delete();  // Deallocate the DataMonitor if it exists
+    }
   }
 
   /**
@@ -71,24 +230,24 @@ public:
    */
   const pop_t &GetPopulation() { return pop; }
 
+  /**
+   * @brief Gets the per-cell arrays of organism points, last task and inputs
+   * 
+   * @return The hot state store, indexed by grid position.
+   */
+  const HotStateStore &GetHotState() const { return hot; }
+
   /**
    * @brief Retrieves the DataMonitor for the organism count
    * 
-   * Initializes the monitor if not already created and sets up the update callback.
+   * Initializes the monitor if not already created; it is filled by the shared statistics pass.
    * 
    * @return Reference to the DataMonitor for organism count.
    */
   emp::DataMonitor<int>& GetOrgCountDataNode() {
       if (!org_count) {
           org_count.New();  // Allocate a new DataMonitor if not already created
-          OnUpdate([this](size_t) {
-              org_count->Reset();  // Reset the monitor on update
-              for (size_t i = 0; i < pop.size(); i++) {
-                  if (IsOccupied(i)) {
-                      org_count->AddDatum(1);  // Add data for each occupied organism
-                  }
-              }
-          });
+          SetupStatsCollector();
       }
       return *org_count;  // Return a reference to the DataMonitor
   }
@@ -96,21 +255,14 @@ public:
   /**
    * @brief Retrieves the DataMonitor for cooperation probability
    * 
-   * Initializes the monitor if not already created and sets up the update callback.
+   * Initializes the monitor if not already created; it is filled by the shared statistics pass.
    * 
    * @return Reference to the DataMonitor for cooperation probability.
    */
   emp::DataMonitor<int, emp::data::Histogram>& GetPointValuesDataNode() {
       if (!point_count) {
           point_count.New();
-          OnUpdate([this](size_t){
-              point_count->Reset();  // Reset before each update
-              for (size_t i = 0; i < pop.size(); ++i) {
-                  if (IsOccupied(i)) {
-                      point_count->AddDatum(pop[i]->GetPoints());
-                  }
-              }
-          });
+          SetupStatsCollector();
       }
       point_count->SetupBins(0,9.1,10); // Set up bins for cooperation values
       return *point_count;
@@ -119,96 +271,451 @@ public:
   /**
    * @brief Retrieves the DataMonitor for tasks completed
    * 
-   * Initializes the monitor if not already created and sets up the update callback.
+   * Initializes the monitor if not already created; it is filled by the shared statistics pass.
    * 
    * @return Reference to the DataMonitor for tasks completed.
    */
   emp::DataMonitor<int, emp::data::Histogram>& GetTasksCompletedDataNode() {
     if (!tasks_completed_monitor) {
       tasks_completed_monitor.New();
-      OnUpdate([this](size_t){
-        tasks_completed_monitor->Reset();
-        for (size_t i = 0; i < pop.size(); ++i) {
-          if (IsOccupied(i)) {
-            int last = pop[i]->GetLastTaskCompleted();  // <-- new accessor needed
-            if (last >= 0) {
-              tasks_completed_monitor->AddDatum(last);
-            }
-          }
-        }
-      });
+      SetupStatsCollector();
     }
     return *tasks_completed_monitor;
   }
 
+  /**
+   * @brief Adds a metric to the shared statistics pass
+   * 
+   * @param reset Called once at the start of each pass.
+   * @param add Called for every living organism during the pass.
+   */
+  void AddStatsStage(std::function<void()> reset, std::function<void(Organism &)> add) {
+    stats_stages.push_back({std::move(reset), std::move(add)});
+    SetupStatsCollector();
+  }
+
+  /**
+   * @brief Sets which updates statistics are gathered and written on
+   * 
+   * The statistics pass, the files from SetupOrgFile and SetupOrgBinaryFile,
+   * OnStatsUpdate hooks and profile rows all run only on sampled updates, so
+   * the cost of collecting goes away along with the rows.
+   * 
+   * @param schedule Every N updates, log-spaced, or the final update only.
+   */
+  void SetStatsSchedule(const StatsSchedule &schedule) {
+    stats_schedule = schedule;
+    stats_flag_update = SIZE_MAX;
+  }
+
+  /**
+   * @brief Checks whether statistics are gathered on the given update
+   * 
+   * Update() decides this once per update; every output asks the same flag.
+   */
+  bool IsStatsUpdate(size_t update) const {
+    return update == stats_flag_update ? stats_flag : stats_schedule.IsSampled(update);
+  }
+
+  /**
+   * @brief Fills every requested monitor and stage in one walk over the population
+   * 
+   * @param update The update being sampled.
+   */
+  void CollectStats(size_t update) {
+    if (!IsStatsUpdate(update)) return;
+    PROFILE_SCOPE(profiler::STATS_TIME);
+
+    if (org_count) org_count->Reset();
+    if (point_count) point_count->Reset();
+    if (tasks_completed_monitor) tasks_completed_monitor->Reset();
+    for (StatsStage &stage : stats_stages) stage.reset();
+
+    for (size_t i : hot.occupied) {
+      if (org_count) org_count->AddDatum(1);
+      if (point_count) point_count->AddDatum(hot.points[i]);
+      if (tasks_completed_monitor) {
+        int last = hot.last_task_completed[i];
+        if (last >= 0) {
+          tasks_completed_monitor->AddDatum(last);
+        }
+      }
+      for (StatsStage &stage : stats_stages) stage.add(*pop[i]);
+    }
+  }
+
+  /**
+   * @brief Gets the settings the current update runs with
+   */
+  const WorldParams &GetParams() const { return params; }
+
+  /**
+   * @brief Replaces the settings, starting with the next update
+   *
+   * The new settings are swapped in whole at the start of Update(), so an
+   * update never mixes old and new values. Safe to call from any thread,
+   * e.g. from an OnUpdate hook that ramps the mutation rate. If called
+   * more than once between updates, the last call wins.
+   *
+   * @param new_params The settings to use from the next update on.
+   */
+  void StageParams(const WorldParams &new_params) {
+    std::lock_guard<std::mutex> lock(staged_params_mutex);
+    staged_params = new_params;
+  }
+
+  /**
+   * @brief Gets the merit an organism at a cell is scheduled by
+   *
+   * Merit is merit_base plus the reward of the last task the organism
+   * completed, or merit_base alone if it has completed none yet.
+   */
+  double GetMerit(size_t pos) const {
+    const int last = hot.last_task_completed[pos];
+    return std::max(params.merit_base + (last < 0 ? 0.0 : Tasks::rewards[last]), 0.0);
+  }
+
+  /**
+   * @brief Sets the key of the input streams of organisms placed from now on
+   *
+   * Each organism's inputs depend only on this seed, its ID and how many
+   * inputs it has drawn (see InputStream), so runs are the same for any
+   * thread count and one organism's inputs can be replayed on their own.
+   *
+   * @param seed The new input seed.
+   */
+  void SetInputSeed(uint64_t seed) { input_seed = seed; }
+
+  /**
+   * @brief Gets the key of the organisms' input streams
+   */
+  uint64_t GetInputSeed() const { return input_seed; }
+
+  /**
+   * @brief Gets the occupied cells, in the order the index keeps them
+   */
+  const OccupiedIndex &GetOccupiedCells() const { return hot.occupied; }
+
+  /// Approximate memory held by a world, in bytes.
+  struct MemoryUsage {
+    size_t organisms = 0;       ///< Living organisms.
+    size_t organism_bytes = 0;  ///< Organism objects, living and pooled.
+    size_t genome_bytes = 0;    ///< Distinct genomes, each counted once however widely shared.
+    size_t world_bytes = 0;     ///< Per-cell arrays: population, hot state, index and queues.
+
+    size_t Total() const { return organism_bytes + genome_bytes + world_bytes; }
+    double PerOrganism() const { return organisms ? double(Total()) / organisms : 0.0; }
+  };
+
+  /**
+   * @brief Adds up the memory the population and its per-cell state take
+   * 
+   * Counts object sizes and container capacities; memory the SignalGP-Lite
+   * CPU allocates internally is not included.
+   */
+  MemoryUsage GetMemoryUsage() const {
+    MemoryUsage usage;
+    usage.organisms = num_orgs;
+    usage.organism_bytes = (num_orgs + org_pool.size()) * sizeof(Organism);
+
+    std::unordered_map<const sgpl::Program<Spec> *, bool> seen;
+    for (size_t pos : hot.occupied) {
+      const sgpl::Program<Spec> *genome = pop[pos]->cpu.GetProgramHandle().get();
+      if (!seen.emplace(genome, true).second) continue;
+      usage.genome_bytes += sizeof(*genome) + genome->capacity() * sizeof(sgpl::Instruction<Spec>);
+    }
+
+    usage.world_bytes = pop.capacity() * sizeof(emp::Ptr<Organism>) + hot.Bytes() +
+                        schedule.capacity() * sizeof(size_t) + birth_queue.Bytes();
+    return usage;
+  }
+
+  /**
+   * @brief Sets how many threads process organisms during each update
+   *
+   * 0 keeps the classic serial update. Any value of 1 or more uses the
+   * chunked update, whose results are the same for every thread count.
+   *
+   * @param threads Number of threads, including the calling thread.
+   */
+  void SetNumThreads(size_t threads) {
+    num_threads = threads;
+    pool.reset();
+    if (num_threads > 1) pool = std::make_unique<ThreadPool>(num_threads);
+  }
+
+  /**
+   * @brief Runs every organism in the schedule across the thread pool
+   *
+   * Each organism draws its inputs from its own counter-based stream, so
+   * nothing it computes depends on which thread runs it. Reproduction
+   * requests are buffered per chunk then appended to the queue in schedule
+   * order. Points only ever change on the organism being run, so they need
+   * no merging.
+   *
+   * @param schedule The order in which to visit cells this update.
+   */
+  void ProcessParallel(const emp::vector<size_t> &schedule) {
+    const size_t num_chunks = (schedule.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (chunk_reproduce_queues.size() < num_chunks) {
+      chunk_reproduce_queues.resize(num_chunks);
+    }
+#ifdef ENABLE_PROFILING
+    if (chunk_profile_counters.size() < num_chunks) {
+      chunk_profile_counters.resize(num_chunks);
+    }
+#endif
+
+    std::function<void(size_t)> process_chunk = [&](size_t chunk) {
+      OrgState::WorldScope world_scope(this);
+#ifdef ENABLE_PROFILING
+      profiler::UseCounters use_counters(chunk_profile_counters[chunk]);
+#endif
+      local_reproduce_queue = &chunk_reproduce_queues[chunk];
+      const size_t end = std::min(schedule.size(), (chunk + 1) * CHUNK_SIZE);
+      for (size_t s = chunk * CHUNK_SIZE; s < end; s++) {
+        const size_t i = schedule[s];
+        pop[i]->Process(i, params.cycles_per_update);
+        if (hot.points[i] > 20) {
+          ReproduceOrg(pop[i]->cpu.state.current_location);
+        }
+      }
+      local_reproduce_queue = nullptr;
+    };
+
+    if (pool) pool->ParallelFor(num_chunks, process_chunk);
+    else for (size_t chunk = 0; chunk < num_chunks; chunk++) process_chunk(chunk);
+
+    for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+      std::vector<uint32_t> &requests = chunk_reproduce_queues[chunk];
+      for (uint32_t cell : requests) birth_queue.Push(cell);
+      requests.clear();
+#ifdef ENABLE_PROFILING
+      profile_counters.Merge(chunk_profile_counters[chunk]);
+      chunk_profile_counters[chunk].Clear();
+#endif
+    }
+  }
+
+  /**
+   * @brief Shares this update's cycle budget out in proportion to merit
+   *
+   * Spends the uniform total (cycles per update times the population) in
+   * slices of cycles-per-update cycles, each given to an organism drawn with
+   * probability proportional to its merit (see GetMerit). Merit follows the
+   * reward of the last task completed rather than points: points are spent
+   * on every birth, so they would punish the organisms that reproduce most,
+   * while the last task's reward is a property of the phenotype that lasts
+   * until it is replaced. Offspring start with no completed task. An
+   * organism's weight is refreshed as soon as it has run, since only the
+   * organism running changes its own last task. Weights are rebuilt from the
+   * schedule once per update to pick up births and deaths. Draws depend on every earlier slice, so this always
+   * runs on the calling thread.
+   */
+  void ProcessByMerit() {
+    merit_sampler.Build(schedule.size(), [this](size_t slot) { return GetMerit(schedule[slot]); });
+    for (size_t slice = 0; slice < schedule.size(); slice++) {
+      if (merit_sampler.Total() <= 0.0) break;
+      const size_t slot = merit_sampler.Find(random.GetDouble(merit_sampler.Total()));
+      const size_t i = schedule[slot];
+      pop[i]->Process(i, params.cycles_per_update);
+      if (hot.points[i] > 20) {
+        ReproduceOrg(pop[i]->cpu.state.current_location);
+      }
+      merit_sampler.Set(slot, GetMerit(i));
+    }
+  }
+
+  /**
+   * @brief Refills the schedule with the occupied cells in a random order
+   *
+   * Only the occupied-cell index is copied and shuffled, into a buffer that is
+   * kept between updates, so the cost scales with the population rather than
+   * the grid area.
+   */
+  void ShuffleSchedule() {
+    schedule.assign(hot.occupied.begin(), hot.occupied.end());
+    emp::Shuffle(random, schedule);
+  }
+
+  /**
+   * @brief Takes an organism out of the population and keeps it for reuse
+   *
+   * Signals the death like RemoveOrgAt, but instead of deleting the organism
+   * puts it in the pool that DoPooledBirth draws from.
+   *
+   * @param pos The position of the organism to retire.
+   */
+  void RetireOrgAt(size_t pos) {
+    if (!IsOccupied(pos)) return;
+    on_death_sig.Trigger(pos);
+    emp::Ptr<Organism> org = pop[pos];
+    org->cpu.state.Detach();
+    pop[pos] = nullptr;
+    --num_orgs;
+    org_pool.push_back(org);
+  }
+
+  /**
+   * @brief Places a mutated offspring of the organism at parent_pos
+   *
+   * Works like DoBirth, but the offspring is built in place inside a retired
+   * organism and the organism it replaces is retired in turn, so once the
+   * pool has warmed up births allocate nothing.
+   *
+   * @param parent_pos The position of the reproducing organism.
+   * @return Where the offspring was placed.
+   */
+  emp::WorldPosition DoPooledBirth(size_t parent_pos) {
+    PROFILE_SCOPE(profiler::BIRTH_TIME);
+    const Organism &parent = *pop[parent_pos];
+    emp::Ptr<Organism> child;
+    if (org_pool.empty()) {
+      child = emp::NewPtr<Organism>(parent);
+      PROFILE_COUNT(profiler::ALLOCATIONS, 1);
+    } else {
+      child = org_pool.back();
+      org_pool.pop_back();
+    }
+    child->BecomeOffspringOf(parent, params.mutation_rate);
+
+    emp::WorldPosition pos = fun_find_birth_pos(child, parent_pos);
+    if (!pos.IsValid() || pos.GetIndex() >= pop.size()) {
+      org_pool.push_back(child);
+      return pos;
+    }
+    RetireOrgAt(pos.GetIndex());
+    AddOrgAt(child, pos, parent_pos);
+    PROFILE_COUNT(profiler::BIRTHS, 1);
+    return pos;
+  }
+
   /**
    * @brief Updates the world by processing each organism and checking for reproduction
    */
   void Update() {
+    OrgState::WorldScope world_scope(this);
+#ifdef ENABLE_PROFILING
+    profiler::UseCounters use_counters(profile_counters);
+    const uint64_t update_start = profiler::Now();
+#endif
+    {
+      std::lock_guard<std::mutex> lock(staged_params_mutex);
+      if (staged_params) {
+        params = *staged_params;
+        staged_params.reset();
+      }
+    }
+    stats_flag_update = update;
+    stats_flag = stats_schedule.IsSampled(update);
     emp::World<Organism>::Update();
 
+    if (params.movement) MovePhase();
+
     // Process each organism
-    emp::vector<size_t> schedule = emp::GetPermutation(random, GetSize());
-    for (int i : schedule) {
-      if (!IsOccupied(i)) continue;
-      pop[i]->Process(i);
-      if (pop[i]->GetPoints() > 20) {
-        ReproduceOrg(pop[i]->cpu.state.current_location);
+    {
+      PROFILE_SCOPE(profiler::PROCESS_TIME);
+      ShuffleSchedule();
+      if (params.merit_scheduling) {
+        ProcessByMerit();
+      } else if (num_threads > 0) {
+        ProcessParallel(schedule);
+      } else {
+        for (int i : schedule) {
+          pop[i]->Process(i, params.cycles_per_update);
+          if (hot.points[i] > 20) {
+            ReproduceOrg(pop[i]->cpu.state.current_location);
+          }
+        }
       }
     }
 
-    // Handle reproduction requests
-    for (emp::WorldPosition location : reproduce_queue) {
-      if (!IsOccupied(location)) continue;
-      std::optional<Organism> offspring = pop[location.GetIndex()]->CheckReproduction();
-      if (offspring.has_value()) {
-        DoBirth(offspring.value(), location.GetIndex());
-      }
+    CommitBirths();
+
+#ifdef ENABLE_PROFILING
+    profiler::Add(profiler::UPDATE_TIME, profiler::Now() - update_start);
+    // Rows follow the statistics interval and hold the totals since the last row
+    if (IsStatsUpdate(update - 1)) {
+      if (profile_report) profile_report->Write(update - 1, profile_counters);
+      profile_counters.Clear();
     }
-    reproduce_queue.clear();
+#endif
+  }
+
+#ifdef ENABLE_PROFILING
+  /**
+   * @brief Writes phase times and op, birth, death and allocation counts to a CSV file
+   * 
+   * Only available in builds compiled with -DENABLE_PROFILING. Rows are
+   * written on the same updates as the statistics pass.
+   * 
+   * @param filename The name of the file to write profile data to.
+   */
+  void SetupProfileFile(const std::string & filename) {
+    profile_report = std::make_unique<profiler::Report>(filename);
   }
+#endif
 
   /**
    * @brief Checks the output of an organism and assigns points based on the best task
    * 
+   * Every task in Tasks is checked at once against the organism's recent inputs.
+   * 
    * @param output The output value to check.
    * @param state The current state of the organism.
    */
-  void CheckOutput(float output, OrgState &state) {
-    float best_points = 0.0;
-    int best_task_index = -1;
-
-    int task_index = -1;
-    for (const auto &task : tasks) {
-        task_index++;
-        float task_points = task->CheckOutput(output, state.last_inputs);
-        if (task_points > best_points) {
-            best_points = task_points;
-            best_task_index = task_index;
-        }
-    }
-
+  void CheckOutput(uint32_t output, OrgState &state) {
+    static_assert(Tasks::size <= INT8_MAX, "Task IDs are stored as int8_t");
+    PROFILE_SCOPE(profiler::CHECK_OUTPUT_TIME);
+    PROFILE_COUNT(profiler::CHECK_OUTPUT_CALLS, 1);
+    int best_task_index = Tasks::Best(Tasks::Match(output, state.Inputs()));
     if (best_task_index != -1) {
-        state.points += best_points;
-        state.last_task_completed = best_task_index;
+        state.Points() += Tasks::rewards[best_task_index];
+        state.LastTaskCompleted() = best_task_index;
     }
   }
 
   /**
    * @brief Reproduces an organism at the given location
    * 
-   * Adds the location to the reproduction queue for future processing.
+   * Adds the location to the birth queue unless it is already there. While a
+   * chunk is being processed the request goes to that chunk's buffer instead,
+   * and repeats are dropped when the buffers are merged.
    * 
    * @param location The location where reproduction is requested.
    */
   void ReproduceOrg(emp::WorldPosition location) {
-    reproduce_queue.push_back(location);
+    if (local_reproduce_queue) {
+      // An organism's requests arrive back to back while it runs
+      if (local_reproduce_queue->empty() || local_reproduce_queue->back() != location.GetIndex()) {
+        local_reproduce_queue->push_back(location.GetIndex());
+      }
+    } else birth_queue.Push(location.GetIndex());
+  }
+
+  /**
+   * @brief Places the offspring of every cell in the birth queue, then empties it
+   *
+   * Cells are handled once each, in the order they first asked, so the
+   * result is deterministic. A cell whose organism was replaced by an
+   * earlier birth in the same batch holds a newborn without points and is
+   * skipped by CheckReproduction. Offspring come from the organism pool, so
+   * once it has warmed up the batch allocates nothing.
+   */
+  void CommitBirths() {
+    PROFILE_SCOPE(profiler::REPRODUCE_QUEUE_TIME);
+    for (uint32_t cell : birth_queue) {
+      if (!IsOccupied(cell)) continue;
+      if (pop[cell]->CheckReproduction()) DoPooledBirth(cell);
+    }
+    birth_queue.Clear();
   }
 
   /**
    * @brief Extracts an organism from a given position
    * 
-   * Removes the organism from the world and returns a pointer to it.
+   * Removes the organism from the world and returns a pointer to it. Its hot
+   * state is copied back out of the world's store.
    * 
    * @param pos The position of the organism to extract.
    * @return A pointer to the extracted organism.
@@ -216,7 +723,10 @@ public:
   emp::Ptr<Organism> ExtractOrganism(size_t pos) {
       if (!IsOccupied(pos)) return nullptr;
       emp::Ptr<Organism> org = pop[pos];
+      org->cpu.state.Detach();
+      hot.occupied.Erase(pos);
       pop[pos] = nullptr;
+      --num_orgs;
       return org;
   }
 
@@ -230,33 +740,101 @@ public:
   void MoveOrganism(size_t pos) {
       if (!IsOccupied(pos)) return;  // No organism to move
 
-      // Step 1: Extract the organism
-      emp::Ptr<Organism> org = ExtractOrganism(pos);
-      if (org == nullptr) return;
-
-      // Step 2: Choose a random neighboring position
+      // Choose a random neighboring position
       emp::WorldPosition new_pos = GetRandomNeighborPos(pos);
 
-      // Step 3: Skip if neighbor is occupied (optional logic)
-      if (IsOccupied(new_pos)) {
-          AddOrgAt(org, pos);  // Return organism to original position
-          return;
+      // Skip if neighbor is occupied (optional logic)
+      if (IsOccupied(new_pos)) return;
+
+      RelocateOrg(pos, new_pos.GetIndex());
+  }
+
+  /**
+   * @brief Moves every organism that can to a random neighboring cell, all at once
+   *
+   * Each organism picks one of the nine cells around and including its own
+   * (wrapping at the edges) from a counter-based draw on its cell, so
+   * choices never depend on processing order. A move only counts if the
+   * target was empty before the phase began; when several organisms pick the
+   * same empty cell, the one with the lowest random claim gets it. Every
+   * organism therefore moves at most once, and the outcome is the same for
+   * any thread count. Intents and claims are computed in chunks of the
+   * occupied-cell index on the thread pool; the winning moves are then
+   * committed in one batch that only updates the population, hot state and
+   * index, without placement or death signals.
+   */
+  void MovePhase() {
+    PROFILE_SCOPE(profiler::MOVE_TIME);
+    const size_t num_movers = hot.occupied.size();
+    if (num_movers == 0) return;
+    const size_t width = GetWidth(), height = GetHeight();
+    const uint32_t move_seed = random.GetUInt();
+
+    if (move_claims_size < pop.size()) {
+      move_claims = std::make_unique<std::atomic<uint64_t>[]>(pop.size());
+      move_claims_size = pop.size();
+      for (size_t i = 0; i < move_claims_size; i++) move_claims[i] = UINT64_MAX;
+    }
+    move_targets.resize(num_movers);
+    move_keys.resize(num_movers);
+
+    const size_t num_chunks = (num_movers + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::function<void(size_t)> claim_chunk = [&](size_t chunk) {
+      const size_t end = std::min(num_movers, (chunk + 1) * CHUNK_SIZE);
+      for (size_t k = chunk * CHUNK_SIZE; k < end; k++) {
+        const uint32_t from = hot.occupied[k];
+        const philox::Counter draw = philox::Block({from, 0, 0, 0}, {move_seed, 0x4d4f5645});
+        const size_t offset = draw[0] % 9;
+        const size_t x = (from % width + width + offset % 3 - 1) % width;
+        const size_t y = (from / width + height + offset / 3 - 1) % height;
+        const uint32_t to = x + y * width;
+        if (hot.occupied.Contains(to)) {  // Includes staying put
+          move_targets[k] = NO_MOVE;
+          continue;
+        }
+        const uint64_t key = uint64_t(draw[1]) << 32 | from;
+        move_targets[k] = to;
+        move_keys[k] = key;
+        std::atomic<uint64_t> &claim = move_claims[to];
+        uint64_t current = claim.load(std::memory_order_relaxed);
+        while (key < current && !claim.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+        }
       }
+    };
+    if (pool) pool->ParallelFor(num_chunks, claim_chunk);
+    else for (size_t chunk = 0; chunk < num_chunks; chunk++) claim_chunk(chunk);
 
-      // Step 4: Move organism to new position
-      AddOrgAt(org, new_pos);
+    moves.clear();
+    for (size_t k = 0; k < num_movers; k++) {
+      const uint32_t to = move_targets[k];
+      if (to == NO_MOVE) continue;
+      if (move_claims[to].load(std::memory_order_relaxed) == move_keys[k]) {
+        moves.emplace_back(hot.occupied[k], to);
+      }
+    }
+    for (size_t k = 0; k < num_movers; k++) {
+      if (move_targets[k] != NO_MOVE) move_claims[move_targets[k]] = UINT64_MAX;
+    }
+
+    // Targets were all empty and distinct, so the moves can be applied in any order
+    for (auto [from, to] : moves) RelocateOrg(from, to);
   }
 
   /**
    * @brief Sets up the file for storing data
    * 
    * Configures the file to record organism count, tasks completed, and other data.
+   * Rows are written on the same updates the statistics pass runs.
    * 
    * @param filename The name of the file to write data to.
    * @return A reference to the data file.
    */
   emp::DataFile & SetupOrgFile(const std::string & filename) {
-    auto & file = SetupFile(filename);
+    const bool append = AddDataOutput(filename);
+    auto file_ptr = emp::NewPtr<OrgDataFile>(filename, append);
+    data_outputs.back().flush = [file_ptr] { file_ptr->Flush(); };
+    auto & file = AddDataFile(file_ptr);
+    file.SetTimingFun([this](size_t update) { return IsStatsUpdate(update); });
 
     // Point count data
     auto & point_node = GetPointValuesDataNode();
@@ -273,19 +851,253 @@ public:
     file.AddTotal(count_node, "total_orgs", "Total number of organisms ever in the world");
 
     // Define histogram bins manually for cooperation values (0.0 to 1.0, step 0.1)
-    task_node.SetupBins(0, tasks.size(), tasks.size()); // tasks.size() should match # of tasks
+    task_node.SetupBins(0, Tasks::size, Tasks::size); // Tasks::size should match # of tasks
 
     // Add one bin per task
-    for (size_t i = 0; i < tasks.size(); ++i) {
+    for (size_t i = 0; i < Tasks::size; ++i) {
         std::string label = "task_" + std::to_string(i);
         std::string desc = "Count of organisms that completed task " + std::to_string(i);
         file.AddHistBin(task_node, i, label, desc);
     }
 
-    file.PrintHeaderKeys();
+    if (!append) file.PrintHeaderKeys();
     
     return file;
   }
+
+  /**
+   * @brief Lists the columns of the organism data file
+   * 
+   * Same keys, order and values as SetupOrgFile, read from the data monitors
+   * after the statistics pass.
+   * 
+   * @return The columns, in file order.
+   */
+  std::vector<OrgColumn> GetOrgColumns() {
+    auto & point_node = GetPointValuesDataNode();
+    auto & task_node = GetTasksCompletedDataNode();
+    auto & count_node = GetOrgCountDataNode();
+    task_node.SetupBins(0, Tasks::size, Tasks::size);
+
+    using columnar::ColumnType;
+    std::vector<OrgColumn> columns{
+      {"update", "Update number", ColumnType::Int, [this] { return static_cast<double>(update); }},
+      {"points", "Total number of points earned", ColumnType::Int, [&point_node] { return point_node.GetTotal(); }},
+      {"mean_tasks", "Mean number of tasks completed", ColumnType::Double, [&task_node] { return task_node.GetMean(); }},
+      {"total_tasks", "Total number of tasks completed", ColumnType::Int, [&task_node] { return task_node.GetTotal(); }},
+      {"total_orgs", "Total number of organisms ever in the world", ColumnType::Int, [&count_node] { return count_node.GetTotal(); }},
+    };
+    for (size_t i = 0; i < Tasks::size; ++i) {
+      columns.push_back({"task_" + std::to_string(i),
+                         "Count of organisms that completed task " + std::to_string(i),
+                         ColumnType::Int,
+                         [&task_node, i] { return static_cast<double>(task_node.GetHistCounts()[i]); }});
+    }
+    return columns;
+  }
+
+  /**
+   * @brief Sets up a binary columnar file with the same columns as SetupOrgFile
+   * 
+   * Rows are written on the same updates the statistics pass runs. Use
+   * export_data to turn the file back into text.
+   * 
+   * @param filename The name of the file to write data to.
+   * @return A reference to the columnar writer.
+   */
+  columnar::Writer & SetupOrgBinaryFile(const std::string & filename) {
+    const bool append = AddDataOutput(filename);
+    columnar_files.push_back(std::make_unique<columnar::Writer>(filename, append));
+    columnar::Writer & file = *columnar_files.back();
+    data_outputs.back().flush = [&file] { file.Flush(); };
+    for (OrgColumn & column : GetOrgColumns()) {
+      file.AddColumn(column.name, column.desc, column.type, std::move(column.get));
+    }
+
+    OnStatsUpdate([&file](size_t) { file.WriteRow(); });
+    return file;
+  }
+
+  /**
+   * @brief Sets up a CSV file like SetupOrgFile, written by a background thread
+   * 
+   * Each sampled row is copied into a bounded ring buffer; formatting and
+   * disk writes happen on the writer thread, so slow storage never stalls
+   * Update(). Integer columns are printed as integers.
+   * 
+   * @param filename The name of the file to write data to.
+   * @return A reference to the writer.
+   */
+  AsyncCsvWriter & SetupOrgAsyncFile(const std::string & filename) {
+    std::vector<OrgColumn> columns = GetOrgColumns();
+    std::vector<AsyncCsvWriter::Column> file_columns;
+    for (const OrgColumn & column : columns) {
+      file_columns.push_back({column.name, column.type == columnar::ColumnType::Int});
+    }
+    const bool append = AddDataOutput(filename);
+    async_files.push_back(std::make_unique<AsyncCsvWriter>(filename, std::move(file_columns), append));
+    AsyncCsvWriter & file = *async_files.back();
+    data_outputs.back().flush = [&file] { file.Flush(); };
+
+    OnStatsUpdate([&file, columns = std::move(columns), row = std::vector<double>()](size_t) mutable {
+      row.clear();
+      for (const OrgColumn & column : columns) row.push_back(column.get());
+      file.Push(row);
+    });
+    return file;
+  }
+
+  /**
+   * @brief Runs a function on every update the statistics pass runs
+   * 
+   * Registered after the statistics pass, so the function sees this
+   * update's monitor values.
+   * 
+   * @param fun Called with the update number.
+   */
+  void OnStatsUpdate(std::function<void(size_t)> fun) {
+    SetupStatsCollector();
+    OnUpdate([this, fun = std::move(fun)](size_t update) {
+      if (IsStatsUpdate(update)) fun(update);
+    });
+  }
+
+  /**
+   * @brief Saves the whole world so a run can later continue bit-exactly
+   * 
+   * Stores the update counter, grid size, both random number generators
+   * (the world's and this thread's sgpl::tlrand), the input seed, each
+   * distinct genome once, and every organism's cell, core state, hot state
+   * and input stream position. Data files are flushed and their sizes
+   * stored, so a resumed run can continue them. Call it between updates.
+   * 
+   * @param filename Where to write the checkpoint; replaced atomically.
+   */
+  void SaveCheckpoint(const std::string & filename) {
+    static_assert(std::is_trivially_copyable<emp::Random>::value,
+                  "Random number generator state is saved as raw bytes");
+    checkpoint::Writer out;
+    out.Put<uint64_t>(update);
+    out.Put<uint64_t>(GetWidth());
+    out.Put<uint64_t>(GetHeight());
+    out.Put(random);
+    out.Put(sgpl::tlrand.Get());
+    out.Put<uint64_t>(input_seed);
+    out.Put<uint64_t>(last_org_id);
+
+    out.Put<uint64_t>(data_outputs.size());
+    for (DataOutput & output : data_outputs) {
+      output.flush();
+      std::error_code error;
+      const uintmax_t size = std::filesystem::file_size(output.filename, error);
+      out.Put<uint64_t>(error ? 0 : size);
+    }
+
+    // Organisms that share a genome share it again after loading
+    std::unordered_map<const sgpl::Program<Spec> *, uint64_t> genome_ids;
+    std::vector<const sgpl::Program<Spec> *> genomes;
+    for (size_t pos : hot.occupied) {
+      const sgpl::Program<Spec> *genome = pop[pos]->cpu.GetProgramHandle().get();
+      if (genome_ids.emplace(genome, genomes.size()).second) genomes.push_back(genome);
+    }
+    out.Put<uint64_t>(genomes.size());
+    for (const sgpl::Program<Spec> *genome : genomes) CPU::SaveProgram(*genome, out);
+
+    // In index order, so loading rebuilds the same index and schedules
+    out.Put<uint64_t>(hot.occupied.size());
+    for (size_t pos : hot.occupied) {
+      Organism & org = *pop[pos];
+      out.Put<uint64_t>(pos);
+      out.Put<uint64_t>(genome_ids[org.cpu.GetProgramHandle().get()]);
+      out.Put<int32_t>(org.tasks_completed);
+      out.Put(hot.points[pos]);
+      out.Put<int32_t>(hot.last_task_completed[pos]);
+      out.Put(hot.last_inputs[pos]);
+      out.Put(hot.last_input_idx[pos]);
+      out.Put<uint64_t>(org.cpu.state.input_stream.GetID());
+      out.Put<uint64_t>(org.cpu.state.input_stream.GetCount());
+      org.cpu.SaveCore(out);
+    }
+    out.Save(filename);
+  }
+
+  /**
+   * @brief Replaces the population with one saved by SaveCheckpoint
+   * 
+   * The grid must already be set up with the checkpoint's size. A full load
+   * also restores the update counter and random number generators, so the
+   * run continues exactly as if it had never stopped. A population-only load
+   * keeps this world's update and generators, to warm-start a new experiment
+   * from an evolved population.
+   * 
+   * Set data files up after a full load, so they continue from the
+   * checkpoint rather than starting over.
+   * 
+   * @param filename The checkpoint to read.
+   * @param population_only Restore just the organisms.
+   */
+  void LoadCheckpoint(const std::string & filename, bool population_only = false) {
+    checkpoint::Reader in(filename);
+    uint64_t saved_update = in.Get<uint64_t>();
+    uint64_t width = in.Get<uint64_t>();
+    uint64_t height = in.Get<uint64_t>();
+    if (width != GetWidth() || height != GetHeight()) {
+      throw std::runtime_error(filename + " was saved from a " + std::to_string(width) +
+                               "x" + std::to_string(height) + " grid");
+    }
+    emp::Random saved_random = random;
+    emp::Random saved_tlrand = sgpl::tlrand.Get();
+    in.Get(saved_random);
+    in.Get(saved_tlrand);
+    uint64_t saved_input_seed = in.Get<uint64_t>();
+    uint64_t saved_last_org_id = in.Get<uint64_t>();
+    // A warm start keeps the organisms' IDs but draws inputs under this world's seed
+    uint64_t stream_seed = population_only ? input_seed : saved_input_seed;
+
+    std::vector<uint64_t> saved_data_sizes(in.Get<uint64_t>());
+    for (uint64_t & size : saved_data_sizes) in.Get(size);
+
+    std::vector<std::shared_ptr<const sgpl::Program<Spec>>> genomes(in.Get<uint64_t>());
+    for (auto & genome : genomes) genome = CPU::LoadProgram(in);
+
+    while (!hot.occupied.empty()) RetireOrgAt(hot.occupied.back());
+    uint64_t count = in.Get<uint64_t>();
+    for (uint64_t i = 0; i < count; i++) {
+      uint64_t pos = in.Get<uint64_t>();
+      uint64_t genome = in.Get<uint64_t>();
+      if (pos >= pop.size() || genome >= genomes.size()) {
+        throw std::runtime_error(filename + " is corrupt");
+      }
+
+      emp::Ptr<Organism> org;
+      if (org_pool.empty()) {
+        org = emp::NewPtr<Organism>();
+      } else {
+        org = org_pool.back();
+        org_pool.pop_back();
+      }
+      org->tasks_completed = in.Get<int32_t>();
+      OrgState & state = org->cpu.state;
+      in.Get(state.Points());
+      state.LastTaskCompleted() = in.Get<int32_t>();
+      auto inputs = in.Get<std::array<uint32_t, 4>>();
+      for (size_t j = 0; j < 4; j++) state.Inputs()[j] = inputs[j];
+      in.Get(state.InputIdx());
+      state.input_stream.Start(stream_seed, in.Get<uint64_t>());
+      state.input_stream.Seek(in.Get<uint64_t>());
+      org->cpu.LoadCore(genomes[genome], in);
+      AddOrgAt(org, pos);
+    }
+
+    last_org_id = std::max(last_org_id, saved_last_org_id);
+    if (!population_only) {
+      input_seed = saved_input_seed;
+      update = saved_update;
+      random = saved_random;
+      sgpl::tlrand.Get() = saved_tlrand;
+      resume_data_sizes = std::move(saved_data_sizes);
+    }
+  }
 };
 
 #endif
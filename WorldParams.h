@@ -0,0 +1,40 @@
+#ifndef WORLDPARAMS_H
+#define WORLDPARAMS_H
+
+#include "ConfigSetup.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/// The settings an OrgWorld reads while it runs, copied out of MyConfigType
+/// once. The world only replaces its copy between updates, so organisms see
+/// one consistent set for a whole update.
+struct WorldParams {
+  double mutation_rate = 0.01;    ///< Per-instruction mutation rate for offspring.
+  size_t cycles_per_update = 10;  ///< CPU cycles each organism runs per update.
+  bool merit_scheduling = false;  ///< Hand out CPU time in proportion to merit.
+  double merit_base = 1.0;        ///< Merit of an organism with no completed task.
+  bool movement = false;          ///< Run the movement phase every update.
+
+  /// Sets merit_scheduling from a SCHEDULER name.
+  /// @param name "uniform" or "merit".
+  void SetScheduler(const std::string &name) {
+    if (name == "uniform") merit_scheduling = false;
+    else if (name == "merit") merit_scheduling = true;
+    else throw std::invalid_argument("Unknown scheduler: " + name);
+  }
+
+  /// @return The parameters in a loaded configuration.
+  static WorldParams FromConfig(const MyConfigType &config) {
+    WorldParams params;
+    params.mutation_rate = config.MUTATION_RATE();
+    params.cycles_per_update = config.CYCLES_PER_UPDATE();
+    params.SetScheduler(config.SCHEDULER());
+    params.merit_base = config.MERIT_BASE();
+    params.movement = config.MOVEMENT();
+    return params;
+  }
+};
+
+#endif // WORLDPARAMS_H
@@ -0,0 +1,275 @@
+// Benchmarks for the simulation hot paths.
+// Compile with `./compile-bench.sh` (same flags as the native build).
+//
+// Usage: ./bench_project [-filter S] [-min-time SECONDS] [-threads N] [-csv] [-label L]
+//   -filter S     Only run benchmarks whose name contains S
+//   -min-time     Seconds to spend timing each benchmark (default 0.5)
+//   -threads N    NUM_THREADS for the full-update benchmarks (default 0)
+//   -csv          Print CSV instead of one JSON object per line
+//   -label L      Tag every result, e.g. with a commit hash, to compare versions
+//
+// Every result reports ns_per_op; CPU and update benchmarks also report
+// org_cycles_per_sec (organisms x CPU cycles executed per second).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "World.h"
+#include "emp/math/Random.hpp"
+
+namespace {
+
+struct Options {
+  std::string filter;
+  double min_time = 0.5;
+  size_t threads = 0;
+  bool csv = false;
+  std::string label;
+};
+
+/// Stops the compiler from optimizing away benchmarked work.
+volatile uint64_t sink = 0;
+
+class Bench {
+  Options options;
+  bool header_printed = false;
+
+  void Report(const std::string &name, uint64_t ops, double seconds, double org_cycles) {
+    double ns_per_op = seconds * 1e9 / ops;
+    double cycles_per_sec = org_cycles > 0 ? org_cycles / seconds : 0.0;
+    if (options.csv) {
+      if (!header_printed) {
+        std::cout << "label,name,ops,ns_per_op,org_cycles_per_sec\n";
+        header_printed = true;
+      }
+      std::cout << options.label << ',' << name << ',' << ops << ',' << ns_per_op << ','
+                << cycles_per_sec << std::endl;
+    } else {
+      std::cout << "{\"label\":\"" << options.label << "\",\"name\":\"" << name
+                << "\",\"ops\":" << ops << ",\"ns_per_op\":" << ns_per_op
+                << ",\"org_cycles_per_sec\":" << cycles_per_sec << "}" << std::endl;
+    }
+  }
+
+public:
+  explicit Bench(Options options) : options(std::move(options)) {}
+
+  const Options &GetOptions() const { return options; }
+
+  /**
+   * Times a benchmark body until the minimum time has passed.
+   *
+   * @param name Benchmark name, used by -filter.
+   * @param body Runs one batch of operations and returns how many it ran.
+   * @param cycles_per_op Organism-cycles each operation executes (0 if not meaningful).
+   */
+  void Run(const std::string &name, const std::function<uint64_t()> &body,
+           double cycles_per_op = 0.0) {
+    if (name.find(options.filter) == std::string::npos) return;
+    using clock = std::chrono::steady_clock;
+
+    body();  // Warm up caches and pools
+    uint64_t ops = 0;
+    auto start = clock::now();
+    double seconds = 0.0;
+    while (seconds < options.min_time) {
+      ops += body();
+      seconds = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    Report(name, ops, seconds, cycles_per_op * ops);
+  }
+
+  /**
+   * Times full world updates, counting the organism-cycles actually run.
+   *
+   * @param name Benchmark name, used by -filter.
+   * @param world The world to update.
+   * @param cycles_per_org CPU cycles each organism runs per update.
+   */
+  void RunUpdates(const std::string &name, OrgWorld &world, size_t cycles_per_org) {
+    if (name.find(options.filter) == std::string::npos) return;
+    using clock = std::chrono::steady_clock;
+
+    world.Update();
+    uint64_t updates = 0;
+    double org_cycles = 0.0;
+    auto start = clock::now();
+    double seconds = 0.0;
+    while (seconds < options.min_time) {
+      org_cycles += static_cast<double>(world.GetNumOrgs()) * cycles_per_org;
+      world.Update();
+      updates++;
+      seconds = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    Report(name, updates, seconds, org_cycles);
+  }
+};
+
+/// A small world plus one detached organism to run instructions against.
+struct InstructionFixture {
+  emp::Random random{1};
+  OrgWorld world{random};
+  OrgState::WorldScope world_scope{&world};
+  Organism org;
+  sgpl::Cpu<Spec> cpu;
+  sgpl::Program<Spec> program{1};
+
+  InstructionFixture() {
+    world.SetPopStruct_Grid(10, 10);
+    world.Resize(10, 10);
+    org.cpu.state.current_location = 0;
+    cpu.TryLaunchCore();
+  }
+
+  /// @return An instruction reading and writing registers 0, 1 and 2.
+  sgpl::Instruction<Spec> MakeInstruction() const {
+    sgpl::Instruction<Spec> inst = program[0];
+    for (size_t i = 0; i < inst.args.size(); i++) inst.args[i] = i % 3;
+    return inst;
+  }
+};
+
+void InstructionBenchmarks(Bench &bench) {
+  constexpr uint64_t batch = 4096;
+  InstructionFixture fix;
+  auto &core = fix.cpu.GetActiveCore();
+  const sgpl::Instruction<Spec> inst = fix.MakeInstruction();
+  OrgState &state = fix.org.cpu.state;
+
+  bench.Run("instruction/io", [&] {
+    for (uint64_t i = 0; i < batch; i++) {
+      IOInstruction::run<Spec>(core, inst, fix.program, state);
+    }
+    sink = sink + GetRegisterBits(core.registers[0]);
+    return batch;
+  });
+
+  bench.Run("instruction/nand", [&] {
+    for (uint64_t i = 0; i < batch; i++) {
+      SetRegisterBits(core.registers[1], uint32_t(i));
+      NandInstruction::run<Spec>(core, inst, fix.program, state);
+    }
+    sink = sink + GetRegisterBits(core.registers[0]);
+    return batch;
+  });
+
+  // Below the reproduction threshold, the path taken on almost every call
+  bench.Run("instruction/reproduce", [&] {
+    for (uint64_t i = 0; i < batch; i++) {
+      state.Points() = 0;
+      ReproduceInstruction::run<Spec>(core, inst, fix.program, state);
+    }
+    return batch;
+  });
+
+  Organism cpu_org;
+  cpu_org.cpu.state.current_location = 0;
+  bench.Run("cpu/run_step_10", [&] {
+    for (uint64_t i = 0; i < 256; i++) {
+      cpu_org.SetPoints(0);
+      cpu_org.cpu.RunCPUStep(10);
+    }
+    return uint64_t(256);
+  }, 10.0);
+}
+
+void TaskBenchmarks(Bench &bench) {
+  constexpr uint64_t batch = 4096;
+  InstructionFixture fix;
+  OrgState &state = fix.org.cpu.state;
+  emp::Random random(2);
+  uint32_t outputs[batch];
+  for (uint32_t &output : outputs) output = random.GetUInt();
+  // Make some outputs solve a task
+  for (uint64_t i = 0; i < batch; i += 4) outputs[i] = COMPLEX::Eval(state.Inputs());
+
+  bench.Run("task/match", [&] {
+    uint32_t solved = 0;
+    for (uint32_t output : outputs) solved |= Tasks::Match(output, state.Inputs());
+    sink = sink + solved;
+    return batch;
+  });
+
+  bench.Run("task/check_output", [&] {
+    for (uint32_t output : outputs) fix.world.CheckOutput(output, state);
+    sink = sink + static_cast<uint64_t>(state.Points());
+    state.Points() = 0;
+    return batch;
+  });
+}
+
+void BirthBenchmarks(Bench &bench) {
+  constexpr uint64_t batch = 256;
+  InstructionFixture fix;
+  Organism parent;
+  Organism child;
+
+  bench.Run("birth/check_reproduction", [&] {
+    uint64_t births = 0;
+    for (uint64_t i = 0; i < batch; i++) {
+      parent.SetPoints(25);
+      births += parent.CheckReproduction();
+    }
+    sink = sink + births;
+    return batch;
+  });
+
+  bench.Run("birth/offspring_mutate", [&] {
+    for (uint64_t i = 0; i < batch; i++) child.BecomeOffspringOf(parent, 0.01);
+    return batch;
+  });
+}
+
+void UpdateBenchmarks(Bench &bench) {
+  for (size_t side : {10, 32, 100}) {
+    for (double occupancy : {0.1, 0.5, 1.0}) {
+      std::string name = "update/" + std::to_string(side) + "x" + std::to_string(side) +
+                         "/" + std::to_string(static_cast<int>(occupancy * 100)) + "pct";
+      if (name.find(bench.GetOptions().filter) == std::string::npos) continue;
+
+      sgpl::tlrand.Get().ResetSeed(1);
+      emp::Random random(1);
+      OrgWorld world(random);
+      world.SetNumThreads(bench.GetOptions().threads);
+      world.SetPopStruct_Grid(side, side);
+      world.Resize(side, side);
+
+      emp::vector<size_t> cells = emp::GetPermutation(random, world.GetSize());
+      size_t count = std::max<size_t>(1, occupancy * world.GetSize());
+      for (size_t i = 0; i < count; i++) {
+        world.AddOrgAt(emp::NewPtr<Organism>(), cells[i]);
+      }
+      bench.RunUpdates(name, world, world.GetParams().cycles_per_update);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-filter" && i + 1 < argc) options.filter = argv[++i];
+    else if (arg == "-min-time" && i + 1 < argc) options.min_time = std::stod(argv[++i]);
+    else if (arg == "-threads" && i + 1 < argc) options.threads = std::stoul(argv[++i]);
+    else if (arg == "-label" && i + 1 < argc) options.label = argv[++i];
+    else if (arg == "-csv") options.csv = true;
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [-filter S] [-min-time SECONDS] [-threads N] [-csv] [-label L]" << std::endl;
+      return 1;
+    }
+  }
+
+  sgpl::tlrand.Get().ResetSeed(1);
+  Bench bench(options);
+  InstructionBenchmarks(bench);
+  TaskBenchmarks(bench);
+  BirthBenchmarks(bench);
+  UpdateBenchmarks(bench);
+}
@@ -0,0 +1 @@
+g++ -O3 -DNDEBUG -march=native -Wall -std=c++17 export_data.cpp -o export_data
@@ -0,0 +1,94 @@
+// Converts binary data files (written with `-OUTPUT_FORMAT binary`) to text.
+// Compile with `c++ -O3 -std=c++17 export_data.cpp -o export_data`
+//
+// Usage: ./export_data [-sep S] [-columns a,b,...] [-prefix P] [-no-header] FILE...
+//   -sep S        Field separator (default ",")
+//   -columns      Only print these columns, in this order (default all)
+//   -prefix P     Text printed at the start of every data row
+//   -no-header    Skip the header line of column names
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ColumnarFile.h"
+
+int main(int argc, char *argv[]) {
+  std::string sep = ",";
+  std::string prefix;
+  std::vector<std::string> wanted;
+  bool header = true;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-sep" && i + 1 < argc) sep = argv[++i];
+    else if (arg == "-prefix" && i + 1 < argc) prefix = argv[++i];
+    else if (arg == "-no-header") header = false;
+    else if (arg == "-columns" && i + 1 < argc) {
+      std::stringstream list(argv[++i]);
+      std::string name;
+      while (std::getline(list, name, ',')) wanted.push_back(name);
+    }
+    else files.push_back(arg);
+  }
+
+  if (files.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [-sep S] [-columns a,b,...] [-prefix P] [-no-header] FILE..." << std::endl;
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+  for (const std::string &filename : files) {
+    try {
+      columnar::Reader reader(filename);
+      const std::vector<columnar::ColumnInfo> &columns = reader.GetColumns();
+
+      // Map the requested names onto file column indices
+      std::vector<size_t> order;
+      if (wanted.empty()) {
+        for (size_t c = 0; c < columns.size(); c++) order.push_back(c);
+      } else {
+        for (const std::string &name : wanted) {
+          size_t c = 0;
+          while (c < columns.size() && columns[c].name != name) c++;
+          if (c == columns.size()) {
+            std::cerr << filename << ": no column named " << name << std::endl;
+            return 1;
+          }
+          order.push_back(c);
+        }
+      }
+
+      if (header) {
+        for (size_t i = 0; i < order.size(); i++) {
+          std::cout << (i ? sep : "") << columns[order[i]].name;
+        }
+        std::cout << '\n';
+        header = false;  // Only once when concatenating files
+      }
+
+      std::vector<std::vector<double>> values;
+      while (reader.ReadBlock(values)) {
+        size_t rows = values.empty() ? 0 : values[0].size();
+        for (size_t r = 0; r < rows; r++) {
+          std::cout << prefix;
+          for (size_t i = 0; i < order.size(); i++) {
+            size_t c = order[i];
+            if (i) std::cout << sep;
+            if (columns[c].type == columnar::ColumnType::Int) {
+              std::cout << static_cast<long long>(values[c][r]);
+            } else {
+              std::cout << values[c][r];
+            }
+          }
+          std::cout << '\n';
+        }
+      }
+    } catch (const std::exception &error) {
+      std::cerr << error.what() << std::endl;
+      return 1;
+    }
+  }
+}
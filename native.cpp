@@ -1,8 +1,14 @@
-// Compile with `c++ -std=c++17 -Isignalgp-lite/include native.cpp`
+// Compile with `c++ -std=c++17 -pthread -Isignalgp-lite/include native.cpp`
 
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include "World.h"
 #include "ConfigSetup.h" 
+#include "ThreadPool.h"
+#include "ReplicateSummary.h"
 #include "emp/base/vector.hpp"
 #include "emp/math/random_utils.hpp"
 #include "emp/math/Random.hpp"
@@ -10,6 +16,189 @@
 
 // This is the main function for the NATIVE version of this project.
 
+/**
+ * Runs one world from its starting population to the final update.
+ *
+ * The world starts from fresh ancestors, from the population in WARM_START,
+ * or, with RESUME set and the checkpoint file present, exactly where that
+ * checkpoint left off. Every CHECKPOINT_INTERVAL updates it is saved again.
+ *
+ * @param config The loaded settings, shared read-only between replicates.
+ * @param seed Seed for this world's emp::Random, sgpl::tlrand and input streams.
+ * @param mutation_rate Per-instruction mutation rate for offspring.
+ * @param filename Where to write this world's data file (empty for none).
+ * @param checkpoint This world's checkpoint file.
+ * @param num_threads Threads that process this world's organisms (0 = serial).
+ * @param summary If set, every sampled row is also folded into this summary.
+ * @param treatment This world's treatment index in the summary.
+ * @param replicate This world's replicate index within its treatment.
+ */
+void RunWorld(const MyConfigType &config, int seed, double mutation_rate,
+              const std::string &filename, const std::string &checkpoint,
+              int num_threads, ReplicateSummary *summary = nullptr,
+              size_t treatment = 0, size_t replicate = 0) {
+  // Some SignalGP-Lite functionality uses its own emp::Random instance
+  // so it's important to set that seed too when the main Random is created.
+  // It is thread-local, so each replicate seeds the copy on its own thread.
+  sgpl::tlrand.Get().ResetSeed(seed);
+
+  emp::Random random(seed);
+  WorldParams params = WorldParams::FromConfig(config);
+  params.mutation_rate = mutation_rate;
+  OrgWorld world(random, params);
+  world.SetInputSeed(seed);
+  world.SetNumThreads(num_threads);
+
+  world.SetPopStruct_Grid(config.GRID_WIDTH(), config.GRID_HEIGHT());
+  // Set the size of the world
+  world.Resize(config.GRID_WIDTH(), config.GRID_HEIGHT());
+
+#ifdef ENABLE_PROFILING
+  world.SetupProfileFile(config.FILE_PATH() + "Profile" + std::to_string(seed) + config.FILE_NAME());
+#endif
+
+  if (summary) {
+    // Every column but the update number
+    std::vector<OrgWorld::OrgColumn> columns = world.GetOrgColumns();
+    columns.erase(columns.begin());
+    std::vector<std::string> names;
+    for (const OrgWorld::OrgColumn &column : columns) names.push_back(column.name);
+    summary->SetMetrics(names);
+
+    world.OnStatsUpdate([summary, treatment, replicate, columns, values = std::vector<double>()](size_t update) mutable {
+      values.clear();
+      for (const OrgWorld::OrgColumn &column : columns) values.push_back(column.get());
+      summary->Add(treatment, replicate, update, values);
+    });
+  }
+
+  if (config.RESUME() && std::ifstream(checkpoint).good()) {
+    world.LoadCheckpoint(checkpoint);
+  } else if (!config.WARM_START().empty()) {
+    world.LoadCheckpoint(config.WARM_START(), true);
+  } else {
+    for (int i = 0; i < config.NUM_START(); i++) {
+      Organism new_org;
+      world.Inject(new_org);
+    }
+  }
+
+  // Setting up data file; after the load, so a resumed run appends to it
+  world.SetStatsSchedule(StatsSchedule::FromConfig(config));
+  if (filename.empty()) {
+    // Summary only
+  } else if (config.OUTPUT_FORMAT() == "binary") {
+    world.SetupOrgBinaryFile(filename);
+  } else if (config.OUTPUT_FORMAT() == "async") {
+    world.SetupOrgAsyncFile(filename);
+  } else {
+    world.SetupOrgFile(filename);
+  }
+
+  const size_t checkpoint_interval = config.CHECKPOINT_INTERVAL();
+  const size_t num_updates = config.NUM_UPDATES();
+  while (world.GetUpdate() < num_updates) {
+    world.Update();
+    if (checkpoint_interval > 0 && world.GetUpdate() % checkpoint_interval == 0) {
+      world.SaveCheckpoint(checkpoint);
+    }
+    // Print the population size
+    //std::cout << "Population size: " << world.GetNumOrgs() << std::endl;
+  }
+
+  if (config.REPORT_MEMORY()) {
+    const OrgWorld::MemoryUsage usage = world.GetMemoryUsage();
+    // One write, so lines from concurrent replicates do not interleave
+    std::ostringstream report;
+    report << filename << ": " << usage.organisms << " organisms, "
+           << usage.PerOrganism() << " bytes per organism (organisms " << usage.organism_bytes
+           << ", genomes " << usage.genome_bytes << ", world " << usage.world_bytes << ")\n";
+    std::cout << report.str() << std::flush;
+  }
+}
+
+/**
+ * Splits a comma-separated list of mutation rates.
+ *
+ * @param list The MUTATION_RATES setting.
+ * @param fallback The rate to use when the list is empty.
+ * @return The rates to sweep, in the order given.
+ */
+emp::vector<double> ParseRates(const std::string &list, double fallback) {
+  emp::vector<double> rates;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) rates.push_back(std::stod(item));
+  }
+  if (rates.empty()) rates.push_back(fallback);
+  return rates;
+}
+
+/**
+ * Runs NUM_REPS seeds for every mutation rate concurrently, one world per
+ * task. Each replicate writes Org_Vals<seed>SP<seed><FILE_NAME>, with an
+ * _MR<rate> tag before FILE_NAME when more than one rate is swept, unless
+ * WRITE_REP_FILES is off. If SUMMARY_FILE is set, the mean, SD and 95% CI
+ * of every column across each rate's replicates are kept as they run, folded
+ * in replicate order so they don't depend on BATCH_THREADS, and written
+ * there at the end. The replicates already fill BATCH_THREADS cores, so each
+ * world runs its updates serially and NUM_THREADS is ignored.
+ *
+ * @param config The loaded settings.
+ */
+void RunBatch(const MyConfigType &config) {
+  emp::vector<double> rates = ParseRates(config.MUTATION_RATES(), config.MUTATION_RATE());
+  size_t threads = config.BATCH_THREADS() > 0 ? config.BATCH_THREADS()
+                                              : std::thread::hardware_concurrency();
+  std::mutex print_mutex;
+
+  std::unique_ptr<ReplicateSummary> summary;
+  if (!config.SUMMARY_FILE().empty()) {
+    std::vector<std::string> labels;
+    for (double rate : rates) {
+      std::stringstream label;
+      label << rate;
+      labels.push_back(label.str());
+    }
+    summary = std::make_unique<ReplicateSummary>(labels);
+  }
+
+  WorkStealingPool pool(threads);
+  std::cout << "Running " << rates.size() * config.NUM_REPS() << " replicates on "
+            << pool.GetNumThreads() << " threads" << std::endl;
+  if (config.NUM_THREADS() > 1) {
+    std::cout << "Warning: ignoring NUM_THREADS " << config.NUM_THREADS()
+              << "; replicates in a batch update serially" << std::endl;
+  }
+
+  for (size_t treatment = 0; treatment < rates.size(); treatment++) {
+    double rate = rates[treatment];
+    for (int rep = 0; rep < config.NUM_REPS(); rep++) {
+      int seed = config.SEED() + rep;
+      std::stringstream filename;
+      filename << config.FILE_PATH() << "Org_Vals" << seed << "SP" << seed;
+      if (rates.size() > 1) filename << "_MR" << rate;
+      filename << config.FILE_NAME();
+      std::string name = config.WRITE_REP_FILES() ? filename.str() : "";
+      std::stringstream checkpoint;
+      checkpoint << config.FILE_PATH() << "Checkpoint" << seed;
+      if (rates.size() > 1) checkpoint << "_MR" << rate;
+      checkpoint << ".ckpt";
+
+      pool.Submit([&config, &print_mutex, &summary, seed, rate, treatment, rep, name,
+                   label = filename.str(), checkpoint = checkpoint.str()] {
+        RunWorld(config, seed, rate, name, checkpoint, 0, summary.get(), treatment, rep);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "Finished " << label << std::endl;
+      });
+    }
+  }
+  pool.Wait();
+
+  if (summary) summary->Write(config.FILE_PATH() + config.SUMMARY_FILE());
+}
+
 int main(int argc, char *argv[]) {
   // Access config values
   MyConfigType config;
@@ -36,32 +225,14 @@ int main(int argc, char *argv[]) {
   std::cout << "Mutation Rate: " << config.MUTATION_RATE() << std::endl;
  // std::cout << "Task Difficulty: " << config.TASK_DIFFICULTY() << std::endl;
 
-  // Some SignalGP-Lite functionality uses its own emp::Random instance
-  // so it's important to set that seed too when the main Random is created
-  sgpl::tlrand.Get().ResetSeed(config.SEED());  // Use SEED from the config
-
-  emp::Random random(config.SEED());  // Use SEED from the config (manual for now)
-  OrgWorld world(random); // This is where I would change the seed
-  std::cout << "Random Seed: " << config.SEED() << std::endl;
-
-
-  world.SetPopStruct_Grid(10, 10);
-  // Set the size of the world
-  world.Resize(10,10);
-
-  // Setting up data file
-  world.SetupOrgFile(config.FILE_PATH()+"Org_Vals"+std::to_string(config.SEED())+config.FILE_NAME());
-
-  for (int i = 0; i < 10; i++){ // THis is also　adding 9 organisms to start each time even though the print says 1
-            // This was causing me SO many issues
-            Organism* new_org = new Organism(&world);
-            world.Inject(*new_org);
-        }
-
-  for (int update = 0; update < 1000; update++) {
-    world.Update();
-    // Print the population size
-    //std::cout << "Population size: " << world.GetNumOrgs() << std::endl;
+  if (config.NUM_REPS() > 1 || !config.MUTATION_RATES().empty()) {
+    RunBatch(config);
+    return 0;
   }
 
+  std::cout << "Random Seed: " << config.SEED() << std::endl;
+  RunWorld(config, config.SEED(), config.MUTATION_RATE(),
+           config.FILE_PATH()+"Org_Vals"+std::to_string(config.SEED())+config.FILE_NAME(),
+           config.FILE_PATH()+"Checkpoint"+std::to_string(config.SEED())+".ckpt",
+           config.NUM_THREADS());
 }
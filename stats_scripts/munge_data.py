@@ -1,4 +1,8 @@
+import subprocess
+
 folder = ''
+# Set to True for runs made with -OUTPUT_FORMAT binary (needs ./export_data)
+binary = False
 
 treatment_postfixes = [1]
 reps = range(1, 51)
@@ -13,6 +17,13 @@ for t in treatment_postfixes:
     for r in reps:
         fname = folder +"Org_Vals" + str(r) + "SP" + str(r) + ".data"
         uid = str(t) + "_" + str(r)
+        if binary:
+            prefix = "{} {} {} ".format(uid, t, r)
+            rows = subprocess.run(["./export_data", "-no-header", "-sep", " ", "-prefix", prefix,
+                                   "-columns", "update,total_orgs,task_8,task_9", fname],
+                                  capture_output=True, text=True, check=True).stdout
+            outFile.write(rows)
+            continue
         curFile = open(fname, 'r')
         for line in curFile:
             if (line[0] != "u"):
@@ -21,9 +21,12 @@ def silent_cmd(command):
 print("Copying MySettings.cfg to "+directory)
 cmd("cp MySettings.cfg "+directory)
 
-for a in seeds:
-   # for b in mutation_rates: -MUTATION_RATE '+str(b)+'
-        command_str = './native_project -SEED '+ str(a) +'  -FILE_PATH '+directory+' -FILE_NAME SP'+ str(a) +'.data'
-        
-        print(command_str)
-        cmd(command_str)
\ No newline at end of file
+# One native_project process runs every seed concurrently and still writes
+# Org_Vals<seed>SP<seed>.data for each one.
+# To sweep mutation rates as well, pass them as a comma-separated -MUTATION_RATES list.
+# For per-update mean/SD/95% CI across seeds without munge_data.py, add:
+# -SUMMARY_FILE summary.dat (plus -WRITE_REP_FILES 0 to skip the per-seed files)
+command_str = './native_project -SEED '+ str(seeds[0]) +' -NUM_REPS '+ str(len(seeds)) +' -FILE_PATH '+directory+' -FILE_NAME .data'
+
+print(command_str)
+cmd(command_str)
\ No newline at end of file
@@ -7,27 +7,33 @@
 #include "World.h"
 #include "Org.h"
 #include "ConfigSetup.h"
+#include "GridRenderer.h"
 #include "emp/config/ArgManager.hpp"
 #include "emp/prefab/ConfigPanel.hpp"
 #include "emp/web/UrlParams.hpp"
 
+#include <chrono>
+#include <stdexcept>
+
 emp::web::Document doc("target");
 emp::web::Document settings("settings");
 emp::web::Document controls("controls");
 MyConfigType config;
 
-const std::unordered_map<int, std::string> task_colors = {
-  {0, "blue"},   // Task 0: NOT
-  {1, "green"},  // Task 1: NAND
-  {2, "red"},    // Task 2: AND
-  {3, "orange"}, // Task 3: OR_N
-  {4, "purple"}, // Task 4:  OR
-  {5, "pink"},   // Task 5: AND_N
-  {6, "cyan"},    // Task 6: NOR
-  {7, "yellow"},    // Task 7: XOR
-  {8, "magenta"},    // Task 8: EQU
-  {9, "gold"}    // Task 9: COMPLEX
+const uint32_t task_colors[] = {
+  GridRenderer::RGBA(0, 0, 255),     // Task 0: NOT (blue)
+  GridRenderer::RGBA(0, 128, 0),     // Task 1: NAND (green)
+  GridRenderer::RGBA(255, 0, 0),     // Task 2: AND (red)
+  GridRenderer::RGBA(255, 165, 0),   // Task 3: OR_N (orange)
+  GridRenderer::RGBA(128, 0, 128),   // Task 4:  OR (purple)
+  GridRenderer::RGBA(255, 192, 203), // Task 5: AND_N (pink)
+  GridRenderer::RGBA(0, 255, 255),   // Task 6: NOR (cyan)
+  GridRenderer::RGBA(255, 255, 0),   // Task 7: XOR (yellow)
+  GridRenderer::RGBA(255, 0, 255),   // Task 8: EQU (magenta)
+  GridRenderer::RGBA(255, 215, 0)    // Task 9: COMPLEX (gold)
 };
+const uint32_t no_task_color = GridRenderer::RGBA(128, 128, 128);  // gray
+const uint32_t empty_color = GridRenderer::RGBA(255, 255, 255);    // white
 
 /**
  * @brief AEAnimator class that manages animation of organisms in a simulation.
@@ -50,6 +56,8 @@ class AEAnimator : public emp::web::Animate {
 
     OrgWorld world{random}; ///< The world where organisms live and interact.
     emp::web::Canvas canvas{width, height, "canvas"}; ///< Canvas for drawing the world.
+    GridRenderer renderer{"canvas", size_t(num_w_boxes), size_t(num_h_boxes), size_t(RECT_SIDE)}; ///< Paints changed cells onto the canvas.
+    double update_ms = 0.0; ///< Running average of how long one update takes.
 
 public:
     /**
@@ -71,6 +79,7 @@ public:
      */
     void SetupCanvas() {
         doc << canvas;
+        renderer.Invalidate();  // The new canvas is blank
 
         // Adds a description of the simulation to the webpage
         doc << R"(
@@ -119,11 +128,24 @@ public:
         emp::prefab::ConfigPanel config_panel(config);
         config_panel.SetRange("NUM_START", "1", "20");
         config_panel.SetRange("MUTATION_RATE", "0.01", "0.07");
+        config_panel.SetRange("FRAME_BUDGET_MS", "0", "30");
         config_panel.ExcludeSetting("SEED");
         config_panel.ExcludeSetting("NUM_TASKS");
         config_panel.ExcludeSetting("FILE_PATH");
         config_panel.ExcludeSetting("FILE_NAME");
-        
+        // The canvas sets the grid size, and the animation runs until stopped
+        config_panel.ExcludeSetting("GRID_WIDTH");
+        config_panel.ExcludeSetting("GRID_HEIGHT");
+        config_panel.ExcludeSetting("NUM_UPDATES");
+        config_panel.ExcludeSetting("MOVEMENT");
+        // Output files, threading, batches and checkpoints only apply to native runs
+        for (const char *name : {"OUTPUT_SCHEDULE", "OUTPUT_INTERVAL", "OUTPUT_FORMAT",
+                                 "NUM_THREADS", "NUM_REPS", "MUTATION_RATES", "BATCH_THREADS",
+                                 "SUMMARY_FILE", "WRITE_REP_FILES", "CHECKPOINT_INTERVAL",
+                                 "RESUME", "WARM_START", "REPORT_MEMORY"}) {
+            config_panel.ExcludeSetting(name);
+        }
+
 
         settings.SetCSS("max-width", "500px");
         settings << config_panel;
@@ -138,44 +160,63 @@ public:
     void SetupWorld() {
         world.SetPopStruct_Grid(num_w_boxes, num_h_boxes);
         world.Resize(num_h_boxes, num_w_boxes);
+        StageConfigParams();
 
         for (int i = 0; i < config.NUM_START(); i++) {
-            Organism* new_org = new Organism(&world);
-            world.Inject(*new_org);
+            Organism new_org;
+            world.Inject(new_org);
         }
     }
 
     /**
-     * @brief Performs operations on each frame when the animation is active.
+     * @brief Hands the current config panel settings to the world.
      *
-     * This function is automatically called on each frame of the animation. It clears the canvas,
-     * moves all organisms, updates the world, and redraws the organisms.
+     * The world picks them up at the start of its next update. Settings that don't parse
+     * (e.g. a scheduler name still being typed) leave the running ones in place.
      */
-    void DoFrame() override {
-        canvas.Clear();
-        MoveAllOrganisms();
-        world.Update();
-        DrawAllOrganisms();
+    void StageConfigParams() {
+        WorldParams params;
+        try {
+            params = WorldParams::FromConfig(config);
+        } catch (const std::invalid_argument &) {
+            return;
+        }
+        params.movement = true;  // Organisms always wander in the web demo
+        world.StageParams(params);
     }
-    
+
     /**
-     * @brief Moves all organisms in the world.
+     * @brief Performs operations on each frame when the animation is active.
      *
-     * This function loops through the world and moves each organism that is occupied in its grid cell.
+     * This function is automatically called on each frame of the animation. It applies the
+     * config panel's current settings, updates the world (which moves every organism first)
+     * as many times as fit in FRAME_BUDGET_MS (at least once), then redraws the cells that
+     * changed.
      */
-    void MoveAllOrganisms() {
-        for (size_t i = 0; i < world.GetSize(); ++i) {
-            if (world.IsOccupied(i)) {
-                world.MoveOrganism(i);
-            }
-        }
+    void DoFrame() override {
+        StageConfigParams();
+        using clock = std::chrono::steady_clock;
+        const clock::time_point start = clock::now();
+        const double budget_ms = config.FRAME_BUDGET_MS();
+        double elapsed_ms = 0.0;
+        do {
+            const clock::time_point update_start = clock::now();
+            world.Update();
+            const clock::time_point update_end = clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(update_end - update_start).count();
+            update_ms = update_ms == 0.0 ? ms : 0.9 * update_ms + 0.1 * ms;
+            elapsed_ms = std::chrono::duration<double, std::milli>(update_end - start).count();
+            // Stop before an update that would likely run past the budget and drop a frame
+        } while (budget_ms > 0 && elapsed_ms + update_ms < budget_ms);
+        DrawAllOrganisms();
     }
-
+    
     /**
      * @brief Draws all organisms in the world.
      *
      * This function draws all the organisms on the canvas based on their grid positions.
-     * It loops through the grid and calls DrawOrganismAt for each position.
+     * It loops through the grid and calls DrawOrganismAt for each position, then copies
+     * the cells whose color changed to the canvas in one call.
      */
     void DrawAllOrganisms() {
         int org_num = 0;
@@ -185,13 +226,14 @@ public:
                 org_num++;
             }
         }
+        renderer.Present();
     }
 
     /**
      * @brief Draws a single organism at the specified coordinates.
      *
-     * This function draws a single organism at the given grid coordinates. The color is determined
-     * by the last task completed by the organism.
+     * This function paints a single organism into the renderer at the given grid coordinates.
+     * The color is determined by the last task completed by the organism.
      * 
      * @param index The index of the organism in the world.
      * @param x The x-coordinate of the organism in the grid.
@@ -199,24 +241,14 @@ public:
      */
     void DrawOrganismAt(int index, int x, int y) {
         if (world.IsOccupied(index)) {
-            auto& org = world.GetOrg(index);
-            int task_id = org.cpu.state.last_task_completed;
-
-            std::string color = "gray"; // default if no task completed
-            if (task_id == 0) color = "blue";
-            else if (task_id == 1) color = "green";
-            else if (task_id == 2) color = "red";
-            else if (task_id == 3) color = "orange";
-            else if (task_id == 4) color = "purple";
-            else if (task_id == 5) color = "pink";
-            else if (task_id == 6) color = "cyan";
-            else if (task_id == 7) color = "yellow";
-            else if (task_id == 8) color = "magenta";
-            else if (task_id == 9) color = "gold";
-
-            canvas.Rect(x * RECT_SIDE, y * RECT_SIDE, RECT_SIDE, RECT_SIDE, color, "black");
+            int task_id = world.GetHotState().last_task_completed[index];
+
+            uint32_t color = no_task_color;
+            if (task_id >= 0 && task_id < 10) color = task_colors[task_id];
+
+            renderer.SetCell(x, y, color);
         } else {
-            canvas.Rect(x * RECT_SIDE, y * RECT_SIDE, RECT_SIDE, RECT_SIDE, "white", "black");
+            renderer.SetCell(x, y, empty_color);
         }
     }
 };